@@ -1,6 +1,11 @@
 #ifndef SYNCTIME_H
 #define SYNCTIME_H
 
+#ifdef SYNCTIME_HOST
+/* Host unit tests (tests/): exec types only, no Amiga headers */
+#include "host.h"
+#else
+
 /* AmigaOS system includes */
 #include <exec/types.h>
 #include <exec/memory.h>
@@ -13,6 +18,7 @@
 #include <libraries/gadtools.h>
 #include <libraries/commodities.h>
 #include <devices/timer.h>
+#include <resources/battclock.h>
 
 #include <proto/exec.h>
 #include <proto/dos.h>
@@ -20,6 +26,7 @@
 #include <proto/gadtools.h>
 #include <proto/commodities.h>
 #include <proto/timer.h>
+#include <proto/battclock.h>
 #include <proto/utility.h>
 #include <clib/alib_protos.h>
 
@@ -42,6 +49,8 @@
 #include <proto/listbrowser.h>
 #include <proto/label.h>
 
+#endif /* SYNCTIME_HOST */
+
 #include <string.h>
 
 /* =========================================================================
@@ -60,18 +69,46 @@
 #define NTP_TO_AMIGA_EPOCH 2461449600UL
 
 /* Configuration defaults */
-#define DEFAULT_SERVER     "pool.ntp.org"
+#define DEFAULT_SERVER     "0.pool.ntp.org 1.pool.ntp.org 2.pool.ntp.org"
 #define DEFAULT_INTERVAL   3600
 #define DEFAULT_TIMEZONE   "America/Los_Angeles"
-#define SERVER_NAME_MAX    128
+#define SERVER_NAME_MAX    128     /* Whole SERVER= list, space/comma separated */
+#define MAX_SERVERS        4       /* Servers queried concurrently */
 #define MIN_INTERVAL       60
 #define MAX_INTERVAL       86400
+#define DEFAULT_BURST      4       /* Requests per sync */
+#define MIN_BURST          1
+#define MAX_BURST          8       /* Must not exceed FILTER_STAGES */
+#define DEFAULT_BURST_SPACING 250  /* Milliseconds between burst requests */
+#define MIN_BURST_SPACING  20
+#define MAX_BURST_SPACING  2000
+#define DEFAULT_POLL_MIN   64      /* Adaptive poll bounds, seconds */
+#define DEFAULT_POLL_MAX   86400
+#define DEFAULT_SLEW_RATE  500     /* Slew speed limit, ppm */
+#define MIN_SLEW_RATE      50
+#define MAX_SLEW_RATE      5000
+#define DEFAULT_STEP_THRESHOLD 128 /* Step instead of slewing above, ms */
+#define MIN_STEP_THRESHOLD 0       /* 0 = always step */
+#define MAX_STEP_THRESHOLD 10000
+#define DEFAULT_DNS_TTL    3600    /* Seconds a DNS answer is reused */
+#define MIN_DNS_TTL        60
+#define MAX_DNS_TTL        604800
+#define DNS_MAX_ADDRS      8       /* Addresses kept per host name */
+#define DEFAULT_BATTCLOCK  86400   /* Seconds between battery clock writes */
+#define MIN_BATTCLOCK      600     /* 0 = never write */
+#define MAX_BATTCLOCK      2592000
 #define RETRY_INTERVAL     30      /* Seconds between retries after first success */
 #define STARTUP_RETRY_INTERVAL 1   /* Seconds between retries before first success */
 
+/* Clock filter register size (samples per server) */
+#define FILTER_STAGES      8
+
 /* Prefs file paths */
 #define PREFS_ENV_PATH     "ENV:SyncTime.prefs"
 #define PREFS_ENVARC_PATH  "ENVARC:SyncTime.prefs"
+#define DNS_ENV_PATH       "ENV:SyncTime.dns"
+#define DNS_ENVARC_PATH    "ENVARC:SyncTime.dns"
+#define STATE_ENVARC_PATH  "ENVARC:SyncTime.state"
 
 /* Commodity */
 #define CX_NAME            "SyncTime"
@@ -86,6 +123,11 @@
 #define STATUS_OK          2
 #define STATUS_ERROR       3
 
+/* network_probe() results */
+#define NET_NO_LIBRARY     0       /* bsdsocket.library will not open */
+#define NET_NO_INTERFACE   1       /* Stack up, no IPv4 address configured */
+#define NET_UP             2
+
 /* =========================================================================
  * Types
  * ========================================================================= */
@@ -94,17 +136,72 @@ typedef struct {
     char  server[SERVER_NAME_MAX];
     LONG  interval;     /* seconds between syncs */
     char  tz_name[48];  /* IANA timezone name, e.g. "America/Los_Angeles" */
+    LONG  burst;          /* requests sent per sync */
+    LONG  burst_spacing;  /* milliseconds between burst requests */
+    LONG  dns_ttl;        /* seconds a cached DNS answer stays fresh */
+    LONG  poll_min;       /* adaptive poll interval bounds, seconds */
+    LONG  poll_max;
+    LONG  slew_rate;      /* max slew speed, ppm */
+    LONG  step_threshold; /* offsets from this many ms on are stepped */
+    LONG  battclock;      /* seconds between battery clock writes, 0 = off */
 } SyncConfig;
 
 typedef struct {
     int   status;              /* STATUS_* */
-    ULONG last_sync_secs;      /* Amiga time of last successful sync */
-    ULONG next_sync_secs;      /* Amiga time of next scheduled sync */
+    ULONG last_sync_secs;      /* UTC of last successful sync */
+    ULONG next_sync_secs;      /* UTC of next scheduled sync */
     char  status_text[64];     /* Human-readable status */
     char  last_sync_text[32];  /* Formatted last sync time */
     char  next_sync_text[32];  /* Formatted next sync time */
 } SyncStatus;
 
+/* Local clock reading taken from the E-clock (clock.c) */
+typedef struct {
+    ULONG secs;                /* Amiga seconds */
+    ULONG micro;
+    struct EClockVal ec;       /* Raw E-clock count at the reading */
+} ClockStamp;
+
+/* Timer queue events (clock.c), one deadline each */
+#define CLOCK_EV_SYNC      0   /* Next sync (main.c) */
+#define CLOCK_EV_ADJUST    1   /* Frequency correction (discipline.c) */
+#define CLOCK_EV_SLEW      2   /* Slew step (clock.c) */
+#define CLOCK_EV_DST       3   /* Next DST transition (main.c) */
+#define CLOCK_EV_BATT      4   /* Battery clock write (clock.c) */
+#define CLOCK_EVENTS       5
+
+/* Timer queue callback, run from the event loop */
+typedef void (*ClockEventFn)(void);
+
+/* Signed 32.32 fixed-point NTP time (ntptime.c). Holds on-wire
+ * timestamps (NTP era seconds, modulo 2^32) as well as differences
+ * between them; value = secs + frac / 2^32. */
+typedef struct {
+    LONG  secs;
+    ULONG frac;
+} NTPTime;
+
+/* On-wire timestamps of one SNTP exchange */
+typedef struct {
+    NTPTime t1;                /* Client transmit (local clock) */
+    NTPTime t2;                /* Server receive */
+    NTPTime t3;                /* Server transmit */
+    NTPTime t4;                /* Client receive (local clock) */
+} SNTPTimestamps;
+
+/* Result of the on-wire calculation */
+typedef struct {
+    NTPTime offset;            /* Server minus local clock */
+    NTPTime delay;             /* Round-trip delay */
+} SNTPResult;
+
+/* Per-server clock filter sample register (filter.c) */
+typedef struct {
+    SNTPResult samples[FILTER_STAGES];
+    UBYTE      count;          /* Valid samples */
+    UBYTE      next;           /* Slot for the next sample */
+} ClockFilter;
+
 /* Timezone entry from generated tz_table.c */
 typedef struct {
     const char *name;       /* Full name: "America/Los_Angeles" */
@@ -115,13 +212,23 @@ typedef struct {
     UBYTE dst_start_month;  /* 1-12, 0 = no DST */
     UBYTE dst_start_week;   /* 1-5, which occurrence of dow */
     UBYTE dst_start_dow;    /* 0=Sun, 1=Mon, ..., 6=Sat */
-    UBYTE dst_start_hour;   /* Local hour of transition */
     UBYTE dst_end_month;
     UBYTE dst_end_week;
     UBYTE dst_end_dow;
-    UBYTE dst_end_hour;
+    WORD dst_start_mins;    /* Local (standard) time of transition, */
+    WORD dst_end_mins;      /* local (DST) time; minutes, may be <0 or >=24h */
+    UWORD trans_first;      /* Exact transitions in tz_transitions[], */
+    UWORD trans_count;      /* 0 if the rules above are exact */
 } TZEntry;
 
+/* Region of tz_table.c: its zones are tz_table[first..first+count-1],
+ * sorted by city */
+typedef struct {
+    const char *name;       /* Region: "America" */
+    UWORD first;            /* Index of its first zone in tz_table[] */
+    UWORD count;            /* Zones in the region */
+} TZRegion;
+
 /* =========================================================================
  * config.c
  * ========================================================================= */
@@ -134,6 +241,12 @@ SyncConfig *config_get(void);
 void        config_set_server(const char *server);
 void        config_set_interval(LONG interval);
 void        config_set_tz_name(const char *name);
+void        config_set_burst(LONG burst, LONG spacing);
+void        config_set_dns_ttl(LONG ttl);
+void        config_set_poll(LONG poll_min, LONG poll_max);
+void        config_set_slew(LONG slew_rate, LONG step_threshold);
+void        config_set_battclock(LONG period);
+ULONG       config_get_servers(char names[][SERVER_NAME_MAX], ULONG max);
 
 /* =========================================================================
  * network.c
@@ -141,19 +254,110 @@ void        config_set_tz_name(const char *name);
 
 BOOL network_init(void);
 void network_cleanup(void);
-BOOL network_resolve(const char *hostname, ULONG *ip_addr);
-BOOL network_send_udp(ULONG ip_addr, UWORD port,
-                      const UBYTE *data, ULONG len);
-LONG network_recv_udp(UBYTE *buf, ULONG buf_size, ULONG timeout_secs);
+ULONG network_resolve(const char *hostname, ULONG *addrs, ULONG max);
+BOOL  network_send_udp(ULONG slot, ULONG ip_addr, UWORD port,
+                       const UBYTE *data, ULONG len, ClockStamp *sent);
+ULONG network_wait_udp(ULONG slots, ULONG timeout_ms, ULONG *sigmask);
+LONG  network_recv_udp(ULONG slot, UBYTE *buf, ULONG buf_size,
+                       ClockStamp *received);
+void  network_close_udp(ULONG slot);
+ULONG network_socket_ops(BOOL reset);
+LONG  network_probe(ULONG *signature, BOOL load);
+
+/* =========================================================================
+ * netready.c - Network readiness detection
+ * ========================================================================= */
+
+void  ready_init(void);
+BOOL  ready_check(ULONG *delay_ms);
+BOOL  ready_quiet(void);
+void  ready_report(BOOL ok);
+
+/* =========================================================================
+ * resolver.c - Asynchronous DNS resolver process
+ * ========================================================================= */
+
+BOOL  resolver_init(void);
+void  resolver_cleanup(void);
+BOOL  resolver_available(void);
+ULONG resolver_signal(void);
+BOOL  resolver_request(ULONG id, const char *hostname);
+BOOL  resolver_get_reply(ULONG *id, ULONG *addrs, ULONG *count);
+void  resolver_cancel(void);
+
+/* =========================================================================
+ * dnscache.c - DNS answer cache
+ * ========================================================================= */
+
+void  dnscache_load(void);
+BOOL  dnscache_save(void);
+BOOL  dnscache_flush(void);
+void  dnscache_store(const char *name, const ULONG *addrs, ULONG count);
+BOOL  dnscache_lookup(const char *name, BOOL allow_stale, ULONG *ip_addr);
+void  dnscache_report(const char *name, ULONG ip_addr, BOOL answered);
+void  dnscache_prefer(const char *name, ULONG ip_addr);
+
+/* =========================================================================
+ * poll.c - Adaptive poll interval
+ * ========================================================================= */
+
+void  poll_reset(void);
+ULONG poll_interval(void);
+void  poll_set(ULONG secs);
+void  poll_update(LONG offset_us, ULONG jitter_us);
+
+/* =========================================================================
+ * discipline.c - Clock frequency discipline
+ * ========================================================================= */
+
+void  discipline_update(LONG offset_us, ULONG err_us, ULONG now_secs);
+void  discipline_tick(void);
+void  discipline_stop(void);
+ULONG discipline_error_bound(void);
+BOOL  discipline_get_freq(LONG *ppb, ULONG *wander_ppb);
+void  discipline_set_freq(LONG ppb, ULONG wander_ppb);
+
+/* =========================================================================
+ * state.c - Persistent discipline state
+ * ========================================================================= */
+
+void  state_load(void);
+void  state_record(LONG offset_us, const char *best_name, ULONG best_ip);
+void  state_flush(void);
 
 /* =========================================================================
  * sntp.c
  * ========================================================================= */
 
-void sntp_build_request(UBYTE *packet);
-BOOL sntp_parse_response(const UBYTE *packet, ULONG *ntp_secs,
-                         ULONG *ntp_frac);
+void  sntp_build_request(UBYTE *packet, const NTPTime *t1);
+BOOL  sntp_parse_response(const UBYTE *packet, SNTPTimestamps *ts);
+BOOL  sntp_compute_offset(const SNTPTimestamps *ts, SNTPResult *res);
 ULONG sntp_ntp_to_amiga(ULONG ntp_secs, const TZEntry *tz);
+ULONG sntp_amiga_to_ntp(ULONG amiga_secs, const TZEntry *tz);
+
+/* =========================================================================
+ * ntptime.c - Fixed-point NTP time arithmetic
+ * ========================================================================= */
+
+void  ntp_add(NTPTime *r, const NTPTime *a, const NTPTime *b);
+void  ntp_sub(NTPTime *r, const NTPTime *a, const NTPTime *b);
+void  ntp_half(NTPTime *r, const NTPTime *a);
+ULONG ntp_frac_to_micro(ULONG frac);
+ULONG ntp_micro_to_frac(ULONG micro);
+LONG  ntp_to_micro(const NTPTime *t);
+void  ntp_from_micro(NTPTime *t, LONG micro);
+void  ntp_to_amiga(const NTPTime *t, ULONG *secs, ULONG *micro);
+void  ntp_from_amiga(NTPTime *t, ULONG secs, ULONG micro);
+
+/* =========================================================================
+ * filter.c - NTP clock filter
+ * ========================================================================= */
+
+void filter_reset(ClockFilter *f);
+void filter_add(ClockFilter *f, const SNTPResult *res);
+BOOL filter_select(const ClockFilter *f, SNTPResult *best, ULONG *jitter);
+BOOL filter_combine(const SNTPResult *cand, const ULONG *jitter, UBYTE n,
+                    SNTPResult *out, ULONG *survivors);
 
 /* =========================================================================
  * tz.c - Timezone database functions
@@ -161,11 +365,20 @@ ULONG sntp_ntp_to_amiga(ULONG ntp_secs, const TZEntry *tz);
 
 extern const TZEntry tz_table[];
 extern const ULONG tz_table_count;
+extern const WORD tz_hash_disp[];    /* Perfect hash index over names, */
+extern const UWORD tz_hash_slot[];   /* generated with tz_table[] */
+extern const TZRegion tz_regions[];
+extern const ULONG tz_region_count;
+extern const ULONG tz_transitions[]; /* Exact transitions, see tz.c */
+extern const ULONG tz_trans_from;    /* Span they cover, UTC seconds */
+extern const ULONG tz_trans_until;
 
 const TZEntry *tz_find_by_name(const char *name);
-const char   **tz_get_regions(ULONG *count);
-const TZEntry **tz_get_cities_for_region(const char *region, ULONG *count);
+const TZRegion *tz_get_regions(ULONG *count);
+const TZEntry  *tz_get_cities(const TZRegion *region, ULONG *count);
 BOOL           tz_is_dst_active(const TZEntry *tz, ULONG utc_secs);
+BOOL           tz_next_transition(const TZEntry *tz, ULONG utc_secs,
+                                  ULONG *next_utc);
 LONG           tz_get_offset_mins(const TZEntry *tz, ULONG utc_secs);
 BOOL           tz_set_env(const TZEntry *tz);
 
@@ -176,14 +389,41 @@ BOOL           tz_set_env(const TZEntry *tz);
 BOOL clock_init(void);
 void clock_cleanup(void);
 BOOL clock_set_system_time(ULONG amiga_secs, ULONG amiga_micro);
+BOOL clock_set_time_at(ULONG amiga_secs, ULONG amiga_micro,
+                       const ClockStamp *at);
 BOOL clock_get_system_time(ULONG *amiga_secs, ULONG *amiga_micro);
+BOOL clock_get_precise_time(ClockStamp *t);
 void clock_format_time(ULONG amiga_secs, char *buf, ULONG buf_size);
 
-/* Timer for periodic sync */
-BOOL  clock_start_timer(ULONG seconds);
-void  clock_abort_timer(void);
-ULONG clock_timer_signal(void);
-BOOL  clock_check_timer(void);  /* Check if timer fired and acknowledge it */
+/* Timer queue: absolute deadlines on one timerequest */
+BOOL  clock_event_in(ULONG ev, ULONG ms, ClockEventFn fn);
+BOOL  clock_event_next(ULONG ev, ULONG ms, ClockEventFn fn);
+void  clock_event_cancel(ULONG ev);
+BOOL  clock_event_pending(ULONG ev);
+ULONG clock_queue_signal(void);
+void  clock_run_events(void);   /* Call the events that came due */
+
+/* UTC timebase: unaffected by DST shifts of the local clock */
+void  clock_set_utc_offset(LONG offset_secs);
+LONG  clock_utc_offset(void);
+void  clock_anchor_utc(ULONG utc_secs, ULONG utc_micro,
+                       const struct EClockVal *at);
+BOOL  clock_get_utc(ULONG *utc_secs, ULONG *utc_micro);
+ULONG clock_utc_to_local(ULONG utc_secs);
+
+/* Small corrections between syncs */
+BOOL  clock_adjust_time(LONG delta_us);
+
+/* Slew engine */
+BOOL  clock_slew(LONG offset_us, ULONG rate_ppm);
+void  clock_stop_slew(void);
+LONG  clock_slew_remaining(void);
+
+/* Battery-backed clock write-back */
+void  clock_battclock_update(ULONG period_secs);
+
+/* Jump detector: TRUE if the clock jumped since the last call */
+BOOL  clock_check_jump(void);
 
 /* =========================================================================
  * window.c
@@ -208,6 +448,7 @@ extern struct Library       *CxBase;
 extern struct Library       *UtilityBase;
 extern struct Library       *SocketBase;
 extern struct Device        *TimerBase;
+extern APTR                  BattClockBase;
 
 /* Reaction class library bases */
 extern struct Library       *WindowBase;
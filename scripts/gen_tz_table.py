@@ -6,7 +6,7 @@ This script parses IANA tzdb Zone and Rule definitions to extract current
 timezone offsets and DST transition rules, outputting tz_table.c for
 compilation into SyncTime.
 
-Usage: python3 scripts/gen_tz_table.py tzdata-dir > src/tz_table.c
+Usage: python3 scripts/gen_tz_table.py [--years FIRST-LAST] tzdata-dir > src/tz_table.c
 
 Zone format example:
     Zone America/Los_Angeles -7:52:58 -  LMT    1883 Nov 18 20:00u
@@ -25,12 +25,20 @@ ON field formats:
     Sun>=8    - first Sunday on or after 8th (second Sunday)
     Sun>=1    - first Sunday of month
     15        - specific day number (we convert to week/dow approximation)
+
+Week/dow rules cannot express every zone (fixed dates, Fri>=23, rules
+that changed recently), so for a span of years (--years, default
+2025-2055) every zone line is also evaluated exactly, zic style. Zones
+whose exact transitions differ from what tz.c derives from the rules
+get them in tz_transitions[]; tz.c uses those inside the span and the
+rules outside it.
 """
 
 import sys
 import os
 import re
 from dataclasses import dataclass, field
+from bisect import bisect_right
 from datetime import date
 from typing import Dict, List, Optional, Tuple
 
@@ -58,6 +66,18 @@ DAYS = {
     'Thu': 4, 'Fri': 5, 'Sat': 6
 }
 
+# Default span of exact transitions, inclusive
+FIRST_YEAR = 2025
+LAST_YEAR = 2055
+
+# Transition table units: offsets in quarter hours, times in minutes
+# (24 bits of them, so at most MAX_SPAN_YEARS)
+QUARTER_HOUR = 900
+MAX_SPAN_YEARS = 31
+
+# Amiga epoch, 1 January 1978, as a proleptic Gregorian ordinal
+EPOCH_ORD = date(1978, 1, 1).toordinal()
+
 
 @dataclass
 class DSTRule:
@@ -65,8 +85,11 @@ class DSTRule:
     month: int = 0        # 1-12
     week: int = 0         # 1-5, 5=last
     dow: int = 0          # 0=Sun, 6=Sat
-    hour: int = 0         # Hour of transition
     offset_mins: int = 0  # Offset to add during this period
+    on: str = '1'         # ON field as written
+    at_secs: int = 0      # AT field, seconds
+    at_suffix: str = 'w'  # w = wall, s = standard, u = UTC
+    save_secs: int = 0    # SAVE field, seconds
 
 
 @dataclass
@@ -88,11 +111,23 @@ class TZEntry:
     dst_start_month: int = 0
     dst_start_week: int = 0
     dst_start_dow: int = 0
-    dst_start_hour: int = 0
+    dst_start_mins: int = 0
     dst_end_month: int = 0
     dst_end_week: int = 0
     dst_end_dow: int = 0
-    dst_end_hour: int = 0
+    dst_end_mins: int = 0
+    transitions: List[Tuple[int, int, bool]] = field(default_factory=list)
+    # Exact (utc, offset_secs, dst) changes in the span, Amiga seconds;
+    # empty if the rules above get the span right
+
+
+@dataclass
+class ZoneLine:
+    """One line of a Zone: offset and rules until a local time."""
+    stdoff_secs: int
+    rules: str             # '-', a Rule name, or a fixed SAVE amount
+    until: Optional[Tuple[int, int, str, int, str]] = None
+    # (year, month, ON, AT secs, AT suffix); None on the last line
 
 
 def parse_offset(offset_str: str) -> int:
@@ -123,19 +158,37 @@ def parse_offset(offset_str: str) -> int:
     return -total_mins if negative else total_mins
 
 
-def parse_time(time_str: str) -> int:
-    """Parse a time string into hours (ignoring suffix like u, s, w).
+def parse_hms(time_str: str) -> Tuple[int, str]:
+    """Parse a time or offset string into (seconds, suffix).
+
+    The suffix is 'w' (wall), 's' (standard) or 'u' (UTC; also written
+    g or z), 'w' if there is none.
 
     Examples:
-        '2:00' -> 2
-        '1:00u' -> 1
-        '23:00s' -> 23
+        '2:00' -> (7200, 'w')
+        '1:00u' -> (3600, 'u')
+        '23:00s' -> (82800, 's')
+        '-0:30' -> (-1800, 'w')
     """
-    # Remove suffix (u=UTC, s=standard, w=wall)
-    time_str = time_str.rstrip('usw')
+    suffix = 'w'
+    if time_str and time_str[-1] in 'wsugz':
+        suffix = time_str[-1]
+        time_str = time_str[:-1]
+        if suffix in 'gz':
+            suffix = 'u'
 
-    parts = time_str.split(':')
-    return int(parts[0])
+    if time_str in ('', '-'):
+        return (0, suffix)
+
+    negative = time_str.startswith('-')
+    if negative:
+        time_str = time_str[1:]
+
+    secs = 0
+    for i, part in enumerate(time_str.split(':')[:3]):
+        secs += int(part) * (3600, 60, 1)[i]
+
+    return (-secs if negative else secs, suffix)
 
 
 def parse_on_field(on_str: str) -> Tuple[int, int]:
@@ -250,15 +303,18 @@ def parse_rules(tzdb_dir: str) -> Dict[str, RuleSet]:
                 # Parse rule details
                 month = MONTHS.get(month_str, 1)
                 week, dow = parse_on_field(on_str)
-                hour = parse_time(at_str)
                 offset_mins = parse_save_field(save_str)
+                at_secs, at_suffix = parse_hms(at_str)
 
                 rule = DSTRule(
                     month=month,
                     week=week,
                     dow=dow,
-                    hour=hour,
-                    offset_mins=offset_mins
+                    offset_mins=offset_mins,
+                    on=on_str,
+                    at_secs=at_secs,
+                    at_suffix=at_suffix,
+                    save_secs=parse_hms(save_str)[0]
                 )
 
                 if name not in rules:
@@ -268,14 +324,13 @@ def parse_rules(tzdb_dir: str) -> Dict[str, RuleSet]:
     return rules
 
 
-def get_current_rules(ruleset: RuleSet) -> Tuple[Optional[DSTRule], Optional[DSTRule]]:
-    """Get the current DST start and end rules from a ruleset.
+def get_current_rules(ruleset: RuleSet, current_year: int) -> Tuple[Optional[DSTRule], Optional[DSTRule]]:
+    """Get the DST start and end rules of a ruleset in a given year.
 
-    Returns (start_rule, end_rule) for the current year and beyond.
-    A rule is 'current' if to_year == 9999 (max).
+    Returns (start_rule, end_rule) in force in current_year, the last
+    year of the span, since tz.c only falls back to them outside it.
     Start rule has offset > 0, end rule has offset == 0.
     """
-    current_year = date.today().year
 
     start_rule = None
     end_rule = None
@@ -290,15 +345,31 @@ def get_current_rules(ruleset: RuleSet) -> Tuple[Optional[DSTRule], Optional[DST
     return start_rule, end_rule
 
 
-def parse_zones(tzdb_dir: str, rules: Dict[str, RuleSet]) -> List[TZEntry]:
+def parse_until(fields: List[str]) -> Optional[Tuple[int, int, str, int, str]]:
+    """Parse the UNTIL columns of a zone line, None if there are none.
+
+    Missing columns default to January, day 1, 0:00 wall time.
+    """
+    if not fields:
+        return None
+
+    year = int(fields[0])
+    month = MONTHS.get(fields[1][:3], 1) if len(fields) > 1 else 1
+    on = fields[2] if len(fields) > 2 else '1'
+    at_secs, at_suffix = parse_hms(fields[3]) if len(fields) > 3 else (0, 'w')
+    return (year, month, on, at_secs, at_suffix)
+
+
+def parse_zones(tzdb_dir: str, rules: Dict[str, RuleSet],
+                first_year: int, last_year: int) -> List[TZEntry]:
     """Parse all Zone definitions and create TZEntry objects.
 
-    Only the last (current) line of each zone is used.
+    The last (current) line of each zone gives its week/dow rules; all
+    of its lines give the exact transitions in first_year..last_year.
     """
     zones: List[TZEntry] = []
     current_zone: Optional[str] = None
-    current_offset: int = 0
-    current_rule_name: Optional[str] = None
+    zone_lines: List[ZoneLine] = []
 
     for filename in TZDB_FILES:
         filepath = os.path.join(tzdb_dir, filename)
@@ -318,47 +389,68 @@ def parse_zones(tzdb_dir: str, rules: Dict[str, RuleSet]) -> List[TZEntry]:
                 # Check for Zone definition start
                 if line.startswith('Zone'):
                     # Save previous zone if it exists
-                    if current_zone:
+                    if current_zone and zone_lines:
                         zones.append(create_tz_entry(
-                            current_zone, current_offset, current_rule_name, rules
+                            current_zone, zone_lines, rules,
+                            first_year, last_year
                         ))
 
                     parts = line.split()
-                    if len(parts) < 3:
+                    zone_lines = []
+                    if len(parts) < 5:
                         current_zone = None
                         continue
 
+                    # Zone NAME STDOFF RULES FORMAT [UNTIL]
                     current_zone = parts[1]
-                    current_offset = parse_offset(parts[2])
-                    current_rule_name = parts[3] if len(parts) > 3 and parts[3] != '-' else None
-
-                    # If there's an UNTIL column (parts >= 5 with year), this isn't the current rule
-                    # Keep parsing continuation lines
+                    zone_lines.append(ZoneLine(
+                        stdoff_secs=parse_hms(parts[2])[0],
+                        rules=parts[3],
+                        until=parse_until(parts[5:])
+                    ))
 
                 # Check for Zone continuation (starts with whitespace)
                 elif current_zone and (line.startswith('\t') or line.startswith(' ')):
                     parts = line.split()
-                    if len(parts) >= 2:
-                        # This is a continuation line
-                        current_offset = parse_offset(parts[0])
-                        current_rule_name = parts[1] if len(parts) > 1 and parts[1] != '-' else None
-                        # If no UNTIL (len < 4 or no year after FORMAT), this is current
+                    if len(parts) >= 3:
+                        # STDOFF RULES FORMAT [UNTIL]
+                        zone_lines.append(ZoneLine(
+                            stdoff_secs=parse_hms(parts[0])[0],
+                            rules=parts[1],
+                            until=parse_until(parts[3:])
+                        ))
 
                 # Link definition - we skip these as they're aliases
                 elif line.startswith('Link'):
                     pass
 
     # Don't forget the last zone
-    if current_zone:
+    if current_zone and zone_lines:
         zones.append(create_tz_entry(
-            current_zone, current_offset, current_rule_name, rules
+            current_zone, zone_lines, rules, first_year, last_year
         ))
 
     return zones
 
 
-def create_tz_entry(zone_name: str, std_offset: int, rule_name: Optional[str],
-                    rules: Dict[str, RuleSet]) -> TZEntry:
+def posix_mins(rule: DSTRule, std_secs: int, save_secs: int) -> int:
+    """Time of a rule in wall time before the change, minutes, as POSIX
+    TZ and tz.c expect: standard time for a start, DST for an end. It
+    may fall outside the day (POSIX allows -167 to 167 hours)."""
+    secs = rule.at_secs
+    if rule.at_suffix == 'u':
+        secs += std_secs + save_secs
+    elif rule.at_suffix == 's':
+        secs += save_secs
+    mins = secs // 60
+    if not -167 * 60 - 59 <= mins <= 167 * 60 + 59:
+        raise ValueError('rule time out of POSIX range')
+    return mins
+
+
+def create_tz_entry(zone_name: str, zone_lines: List[ZoneLine],
+                    rules: Dict[str, RuleSet],
+                    first_year: int, last_year: int) -> TZEntry:
     """Create a TZEntry from zone information and rules."""
     # Parse region and city from zone name
     if '/' in zone_name:
@@ -369,36 +461,371 @@ def create_tz_entry(zone_name: str, std_offset: int, rule_name: Optional[str],
         region = zone_name
         city = zone_name
 
+    current = zone_lines[-1]
+    std_secs = current.stdoff_secs
+    std_mins = (abs(std_secs) + 30) // 60
+
     entry = TZEntry(
         name=zone_name,
         region=region,
         city=city,
-        std_offset_mins=std_offset
+        std_offset_mins=-std_mins if std_secs < 0 else std_mins
     )
 
     # Look up DST rules if a rule name is specified
-    if rule_name and rule_name in rules:
-        ruleset = rules[rule_name]
-        start_rule, end_rule = get_current_rules(ruleset)
+    if current.rules in rules:
+        ruleset = rules[current.rules]
+        start_rule, end_rule = get_current_rules(ruleset, last_year)
 
         if start_rule and end_rule:
             entry.dst_offset_mins = start_rule.offset_mins
             entry.dst_start_month = start_rule.month
             entry.dst_start_week = start_rule.week
             entry.dst_start_dow = start_rule.dow
-            entry.dst_start_hour = start_rule.hour
+            entry.dst_start_mins = posix_mins(start_rule, std_secs, 0)
             entry.dst_end_month = end_rule.month
             entry.dst_end_week = end_rule.week
             entry.dst_end_dow = end_rule.dow
-            entry.dst_end_hour = end_rule.hour
+            entry.dst_end_mins = posix_mins(end_rule, std_secs,
+                                            start_rule.save_secs)
+
+    # Keep the exact transitions only where the rules get them wrong
+    exact = span_transitions(zone_transitions(zone_lines, rules, first_year,
+                                              last_year),
+                             first_year, last_year)
+    if not rules_match(entry, exact, first_year, last_year):
+        entry.transitions = exact
 
     return entry
 
 
-def generate_c_output(zones: List[TZEntry]) -> str:
+# =========================================================================
+# Exact transitions
+# =========================================================================
+
+def year_start(year: int) -> int:
+    """Amiga seconds of 1 January of a year, 00:00 UTC."""
+    return (date(year, 1, 1).toordinal() - EPOCH_ORD) * 86400
+
+
+def day_ordinal(year: int, month: int, on: str) -> int:
+    """Proleptic Gregorian ordinal of an ON day (lastSun, Sun>=8,
+    Fri<=1, 15). Sun>=N and Dow<=N may cross into the next or previous
+    month, as in zic."""
+    if on.startswith('last'):
+        if month == 12:
+            day = date(year + 1, 1, 1).toordinal() - 1
+        else:
+            day = date(year, month + 1, 1).toordinal() - 1
+        return day - (day - DAYS[on[4:7]]) % 7
+
+    match = re.match(r'(\w+)([<>]=)(\d+)', on)
+    if match:
+        dow = DAYS[match.group(1)[:3]]
+        day = date(year, month, int(match.group(3))).toordinal()
+        if match.group(2) == '>=':
+            return day + (dow - day) % 7
+        return day - (day - dow) % 7
+
+    return date(year, month, int(on)).toordinal()
+
+
+def local_secs(year: int, month: int, on: str, at_secs: int) -> int:
+    """Amiga seconds of a local date and time, taken as UTC."""
+    return (day_ordinal(year, month, on) - EPOCH_ORD) * 86400 + at_secs
+
+
+def to_utc(secs: int, suffix: str, stdoff: int, save: int) -> int:
+    """UTC of a time with an AT suffix, given the offsets in force."""
+    if suffix == 'u':
+        return secs
+    if suffix == 's':
+        return secs - stdoff
+    return secs - stdoff - save
+
+
+def zone_transitions(zone_lines: List[ZoneLine], rules: Dict[str, RuleSet],
+                     first_year: int, last_year: int) -> List[Tuple[int, int, bool]]:
+    """Exact (utc, offset_secs, dst) changes of a zone, zic style.
+
+    Rules are only evaluated from two years before the span (or the
+    start of a zone line) on, so the list is exact from first_year;
+    anything earlier is for the state at the span start only.
+    """
+    changes: List[Tuple[int, int, bool]] = []
+    start = -(1 << 62)  # UTC start of the current line
+    prev_stdoff = prev_save = 0  # Offsets in force just before it
+    end_year = last_year + 1
+
+    for line in zone_lines:
+        stdoff = line.stdoff_secs
+        events: List[Tuple[int, int]] = []  # (utc, save) in order
+        first_after = 0  # Index of the first event after the start
+
+        if line.rules in rules:
+            hi = min(line.until[0], end_year) if line.until else end_year
+            lo = first_year - 2
+            if start > -(1 << 62):
+                lo = max(lo, date.fromordinal(EPOCH_ORD + start // 86400).year - 1)
+            lo = min(lo, hi - 1)
+
+            local: List[Tuple[int, DSTRule]] = []
+            for from_yr, to_yr, rule in rules[line.rules].rules:
+                for year in range(max(from_yr, lo), min(to_yr, hi) + 1):
+                    local.append((local_secs(year, rule.month, rule.on,
+                                             rule.at_secs), rule))
+            local.sort(key=lambda e: e[0])
+
+            # An event is still on the previous line's clock if, read
+            # with its offsets, it falls at or before the start (a rule
+            # change at the same wall time as the zone change)
+            save = 0
+            for secs, rule in local:
+                utc = to_utc(secs, rule.at_suffix, stdoff, save)
+                if utc <= start or \
+                        to_utc(secs, rule.at_suffix, prev_stdoff, prev_save) <= start:
+                    first_after = len(events) + 1
+                events.append((utc, rule.save_secs))
+                save = rule.save_secs
+            fixed = 0
+        elif line.rules == '-':
+            fixed = 0
+        else:
+            fixed = parse_hms(line.rules)[0]
+
+        # Save in force when the line starts: the last earlier event's
+        save = events[first_after - 1][1] if first_after > 0 else fixed
+
+        # Until, in UTC, with the save in force just before it
+        until = None
+        until_save = save
+        if line.until:
+            year, month, on, at_secs, suffix = line.until
+            secs = local_secs(year, month, on, at_secs)
+            for utc, ev_save in events[first_after:]:
+                if utc >= to_utc(secs, suffix, stdoff, until_save):
+                    break
+                until_save = ev_save
+            until = to_utc(secs, suffix, stdoff, until_save)
+
+        changes.append((start, stdoff + save, save != 0))
+        for utc, ev_save in events[first_after:]:
+            if until is None or utc < until:
+                changes.append((utc, stdoff + ev_save, ev_save != 0))
+
+        if until is None:
+            break
+        start = until
+        prev_stdoff, prev_save = stdoff, until_save
+
+    return changes
+
+
+def span_transitions(changes: List[Tuple[int, int, bool]],
+                     first_year: int, last_year: int) -> List[Tuple[int, int, bool]]:
+    """Cut a zone's changes down to the span: the state at its start,
+    then every change of offset or DST flag until its end."""
+    span_from = year_start(first_year)
+    span_until = year_start(last_year + 1)
+
+    state = changes[0]
+    for change in changes:
+        if change[0] > span_from:
+            break
+        state = change
+    result = [(span_from, state[1], state[2])]
+
+    for utc, offset, dst in changes:
+        if span_from < utc < span_until and \
+                (offset, dst) != result[-1][1:]:
+            result.append((utc, offset, dst))
+
+    return result
+
+
+def nth_dow_of_month(year: int, month: int, week: int, dow: int) -> int:
+    """Day of month of a week/dow rule. Must match nth_dow_of_month()
+    in src/tz.c."""
+    if month < 1 or month > 12 or week < 1 or week > 5 or dow > 6:
+        return 1
+
+    first = date(year, month, 1).toordinal()
+    if month == 12:
+        days = date(year + 1, 1, 1).toordinal() - first
+    else:
+        days = date(year, month + 1, 1).toordinal() - first
+
+    day = 1 + (dow - first % 7) % 7
+    if week == 5:
+        while day + 7 <= days:
+            day += 7
+        return day
+    return min(day + (week - 1) * 7, days)
+
+
+def rule_transitions(entry: TZEntry, year: int) -> Tuple[int, int]:
+    """DST start and end of a year in local standard seconds, as
+    dst_transitions() in src/tz.c derives them."""
+    start = (date(year, entry.dst_start_month,
+                  nth_dow_of_month(year, entry.dst_start_month,
+                                   entry.dst_start_week,
+                                   entry.dst_start_dow)).toordinal() -
+             EPOCH_ORD) * 86400 + entry.dst_start_mins * 60
+    end = (date(year, entry.dst_end_month,
+                nth_dow_of_month(year, entry.dst_end_month,
+                                 entry.dst_end_week,
+                                 entry.dst_end_dow)).toordinal() -
+           EPOCH_ORD) * 86400 + entry.dst_end_mins * 60
+    return start, end - entry.dst_offset_mins * 60
+
+
+def rule_state(entry: TZEntry, utc: int) -> Tuple[int, bool]:
+    """(offset_secs, dst) at a UTC time by the week/dow rules, as
+    tz_get_offset_mins() and tz_is_dst_active() compute it."""
+    std = entry.std_offset_mins * 60
+    if entry.dst_start_month == 0 or entry.dst_offset_mins == 0:
+        return (std, False)
+
+    local = utc + std
+    year = date.fromordinal(EPOCH_ORD + local // 86400).year
+    start, end = rule_transitions(entry, year)
+    if entry.dst_start_month < entry.dst_end_month:
+        dst = start <= local < end
+    else:
+        dst = local >= start or local < end
+
+    return (std + entry.dst_offset_mins * 60 if dst else std, dst)
+
+
+def rules_match(entry: TZEntry, exact: List[Tuple[int, int, bool]],
+                first_year: int, last_year: int) -> bool:
+    """Check the week/dow rules against the exact changes in the span.
+
+    Both are constant between their change points, so comparing the
+    state at each of them is enough.
+    """
+    span_until = year_start(last_year + 1)
+    points = [utc for utc, _, _ in exact]
+
+    if entry.dst_start_month != 0 and entry.dst_offset_mins != 0:
+        std = entry.std_offset_mins * 60
+        for year in range(first_year - 1, last_year + 2):
+            for secs in rule_transitions(entry, year):
+                if exact[0][0] < secs - std < span_until:
+                    points.append(secs - std)
+
+    utcs = [utc for utc, _, _ in exact]
+    for utc in points:
+        _, offset, dst = exact[bisect_right(utcs, utc) - 1]
+        if rule_state(entry, utc) != (offset, dst):
+            return False
+
+    return True
+
+
+def name_hash(name: str) -> int:
+    """djb2-xor string hash, 32-bit. Must match name_hash() in src/tz.c."""
+    h = 5381
+    for c in name.encode('utf-8'):
+        h = (((h << 5) + h) ^ c) & 0xFFFFFFFF
+    return h
+
+
+def mix_hash(h: int) -> int:
+    """Thomas Wang's shift-only 32-bit mix. Must match mix_hash() in src/tz.c."""
+    h = (~h + (h << 15)) & 0xFFFFFFFF
+    h ^= h >> 12
+    h = (h + (h << 2)) & 0xFFFFFFFF
+    h ^= h >> 4
+    h = (h + (h << 3) + (h << 11)) & 0xFFFFFFFF
+    h ^= h >> 16
+    return h
+
+
+def build_perfect_hash(names: List[str]) -> Tuple[List[int], List[int]]:
+    """Build a minimal perfect hash over names (hash and displace).
+
+    Each name falls in bucket mix_hash(h) % n, h = name_hash(name). A
+    bucket's displacement d > 0 puts its names in slots
+    mix_hash(h ^ d) % n; d < 0 puts its single name in slot -d - 1.
+    Buckets are placed largest first, searching for the smallest d
+    that lands all their names in free slots.
+
+    Returns (displacements per bucket, table index per slot).
+    """
+    n = len(names)
+    hashes = [name_hash(name) for name in names]
+    if len(set(hashes)) != n:
+        raise ValueError('zone names collide in name_hash()')
+
+    buckets: List[List[int]] = [[] for _ in range(n)]
+    for i, h in enumerate(hashes):
+        buckets[mix_hash(h) % n].append(i)
+
+    disp = [0] * n
+    slot_of = [-1] * n
+    order = sorted(range(n), key=lambda b: len(buckets[b]), reverse=True)
+
+    for b in order:
+        members = buckets[b]
+        if len(members) <= 1:
+            break
+        for d in range(1, 32768):
+            slots = [mix_hash(hashes[i] ^ d) % n for i in members]
+            if len(set(slots)) == len(slots) and \
+                    all(slot_of[s] < 0 for s in slots):
+                break
+        else:
+            raise ValueError('no displacement found for a bucket')
+        disp[b] = d
+        for i, s in zip(members, slots):
+            slot_of[s] = i
+
+    # Single-name buckets go straight into the free slots
+    free = [s for s in range(n) if slot_of[s] < 0]
+    for b in order:
+        if len(buckets[b]) == 1:
+            s = free.pop()
+            disp[b] = -s - 1
+            slot_of[s] = buckets[b][0]
+
+    return disp, slot_of
+
+
+def encode_transitions(zone: TZEntry, first_year: int) -> List[int]:
+    """Encode a zone's exact transitions for tz_transitions[].
+
+    Each is a ULONG: bit 31 set on DST, bits 30-24 the total UTC
+    offset in quarter hours (signed), bits 23-0 minutes since the start
+    of the span. Sorted by time, for a binary search.
+    """
+    span_from = year_start(first_year)
+    records = []
+    for utc, offset, dst in zone.transitions:
+        mins, rem = divmod(utc - span_from, 60)
+        if rem or offset % QUARTER_HOUR:
+            raise ValueError(f'{zone.name}: transition not on a whole minute')
+        quarters = offset // QUARTER_HOUR
+        if mins > 0xFFFFFF or not -64 <= quarters <= 63:
+            raise ValueError(f'{zone.name}: transition out of range')
+        records.append((0x80000000 if dst else 0) |
+                       ((quarters & 0x7F) << 24) | mins)
+    return records
+
+
+def generate_c_output(zones: List[TZEntry], first_year: int, last_year: int) -> str:
     """Generate the C source file content."""
-    # Sort zones by name
-    zones.sort(key=lambda z: z.name)
+    # Sort zones by region, then city: each region is one slice of the
+    # table (see tz_regions[] below)
+    zones.sort(key=lambda z: (z.region, z.city))
+
+    # Exact transitions, one run per zone that needs them
+    transitions: List[int] = []
+    runs: Dict[str, Tuple[int, int]] = {}
+    for zone in zones:
+        records = encode_transitions(zone, first_year)
+        runs[zone.name] = (len(transitions) if records else 0, len(records))
+        transitions.extend(records)
 
     lines = []
     lines.append('/* tz_table.c - Generated timezone table from IANA tzdb */')
@@ -417,9 +844,11 @@ def generate_c_output(zones: List[TZEntry]) -> str:
         line = f'    {{"{name}", "{region}", "{city}", '
         line += f'{zone.std_offset_mins}, {zone.dst_offset_mins}, '
         line += f'{zone.dst_start_month}, {zone.dst_start_week}, '
-        line += f'{zone.dst_start_dow}, {zone.dst_start_hour}, '
+        line += f'{zone.dst_start_dow}, '
         line += f'{zone.dst_end_month}, {zone.dst_end_week}, '
-        line += f'{zone.dst_end_dow}, {zone.dst_end_hour}}},'
+        line += f'{zone.dst_end_dow}, '
+        line += f'{zone.dst_start_mins}, {zone.dst_end_mins}, '
+        line += f'{runs[zone.name][0]}, {runs[zone.name][1]}}},'
         lines.append(line)
 
     lines.append('};')
@@ -427,20 +856,79 @@ def generate_c_output(zones: List[TZEntry]) -> str:
     lines.append(f'const ULONG tz_table_count = {len(zones)};')
     lines.append('')
 
+    # Region descriptors: name, first index, count
+    regions: List[Tuple[str, int, int]] = []
+    for i, zone in enumerate(zones):
+        if regions and regions[-1][0] == zone.region:
+            name, first, count = regions[-1]
+            regions[-1] = (name, first, count + 1)
+        else:
+            regions.append((zone.region, i, 1))
+
+    lines.append('const TZRegion tz_regions[] = {')
+    for name, first, count in regions:
+        name = name.replace('\\', '\\\\').replace('"', '\\"')
+        lines.append(f'    {{"{name}", {first}, {count}}},')
+    lines.append('};')
+    lines.append('')
+    lines.append(f'const ULONG tz_region_count = {len(regions)};')
+    lines.append('')
+
+    # Perfect hash index for tz_find_by_name()
+    disp, slots = build_perfect_hash([z.name for z in zones])
+    lines.append('/* Perfect hash over the names: displacement per bucket */')
+    lines.append('const WORD tz_hash_disp[] = {')
+    for i in range(0, len(disp), 12):
+        lines.append('    ' + ', '.join(str(d) for d in disp[i:i + 12]) + ',')
+    lines.append('};')
+    lines.append('')
+    lines.append('/* Perfect hash over the names: tz_table[] index per slot */')
+    lines.append('const UWORD tz_hash_slot[] = {')
+    for i in range(0, len(slots), 12):
+        lines.append('    ' + ', '.join(str(x) for x in slots[i:i + 12]) + ',')
+    lines.append('};')
+    lines.append('')
+
+    # Exact transitions for zones the week/dow rules get wrong
+    lines.append(f'/* Exact transitions {first_year}-{last_year}: DST, offset, minutes */')
+    lines.append('const ULONG tz_transitions[] = {')
+    if not transitions:
+        lines.append('    0,')
+    for i in range(0, len(transitions), 6):
+        lines.append('    ' + ' '.join(f'0x{t:08X},' for t in transitions[i:i + 6]))
+    lines.append('};')
+    lines.append('')
+    lines.append(f'const ULONG tz_trans_from = {year_start(first_year)}UL;')
+    lines.append(f'const ULONG tz_trans_until = {year_start(last_year + 1)}UL;')
+    lines.append('')
+
     return '\n'.join(lines)
 
 
 def main():
     """Main entry point."""
-    if len(sys.argv) < 2:
-        print(f"Usage: {sys.argv[0]} <tzdb-directory>", file=sys.stderr)
+    args = sys.argv[1:]
+    first_year, last_year = FIRST_YEAR, LAST_YEAR
+
+    if len(args) >= 2 and args[0] == '--years':
+        match = re.match(r'(\d{4})-(\d{4})$', args[1])
+        if not match or not 1978 <= int(match.group(1)) <= int(match.group(2)) \
+                or int(match.group(2)) - int(match.group(1)) >= MAX_SPAN_YEARS:
+            print(f"Error: bad year span '{args[1]}'", file=sys.stderr)
+            sys.exit(1)
+        first_year, last_year = int(match.group(1)), int(match.group(2))
+        args = args[2:]
+
+    if len(args) < 1:
+        print(f"Usage: {sys.argv[0]} [--years FIRST-LAST] <tzdb-directory>", file=sys.stderr)
         print("", file=sys.stderr)
         print("Parses IANA tzdb source files and generates tz_table.c", file=sys.stderr)
+        print(f"Exact transitions cover FIRST-LAST (default {FIRST_YEAR}-{LAST_YEAR})", file=sys.stderr)
         print("", file=sys.stderr)
         print("Example: python3 scripts/gen_tz_table.py tzdb-2025c > src/tz_table.c", file=sys.stderr)
         sys.exit(1)
 
-    tzdb_dir = sys.argv[1]
+    tzdb_dir = args[0]
 
     if not os.path.isdir(tzdb_dir):
         print(f"Error: '{tzdb_dir}' is not a directory", file=sys.stderr)
@@ -453,7 +941,7 @@ def main():
 
     # Parse zones
     print(f"Parsing zones from {tzdb_dir}...", file=sys.stderr)
-    zones = parse_zones(tzdb_dir, rules)
+    zones = parse_zones(tzdb_dir, rules, first_year, last_year)
     print(f"Found {len(zones)} zones", file=sys.stderr)
 
     # Filter out zones without '/' and Etc/ zones
@@ -461,10 +949,12 @@ def main():
     print(f"After filtering: {len(zones)} zones", file=sys.stderr)
 
     # Generate output
-    output = generate_c_output(zones)
+    output = generate_c_output(zones, first_year, last_year)
     print(output)
 
     print(f"Generated tz_table.c with {len(zones)} entries", file=sys.stderr)
+    print(f"Exact transitions for {sum(1 for z in zones if z.transitions)} zones, "
+          f"{sum(len(z.transitions) for z in zones)} records", file=sys.stderr)
 
 
 if __name__ == '__main__':
@@ -2,6 +2,33 @@
 
 #include "synctime.h"
 
+/* Slew engine pace: one adjustment per tick */
+#define SLEW_TICK_MS 1000
+
+/* E-clock timestamps: re-anchor to the system clock this often */
+#define EC_ANCHOR_SECS 64
+
+/* Span over which the E-clock rate is measured, seconds */
+#define EC_RATE_SECS 1024
+
+/* Clock moved by more than this behind our back: start the rate
+ * measurement over, microseconds */
+#define EC_MAX_SLIP_US 50000L
+
+/* Battery clock writes must land this close after a second boundary,
+ * microseconds */
+#define BATT_SLACK_US 10000UL
+
+/* Jump detector: the clock moved this far from where the E-clock says
+ * it should be, microseconds, plus 1/JUMP_RATE_DIV of the time since
+ * the anchor (the E-clock rate may be off until calibrated) */
+#define JUMP_US 1000000L
+#define JUMP_RATE_DIV 16
+
+/* Jump detector: system time drifted this far from the battery
+ * clock, seconds (the battery clock only counts whole seconds) */
+#define JUMP_BATT_SECS 4
+
 /* --------------------------------------------------------------------------
  * Static state
  * -------------------------------------------------------------------------- */
@@ -10,12 +37,57 @@
 static struct MsgPort     *main_port     = NULL;
 static struct timerequest *main_treq     = NULL;
 
-/* Periodic timerequest: used for async sync scheduling timer */
-static struct MsgPort     *periodic_port = NULL;
-static struct timerequest *periodic_treq = NULL;
+/* Queue timerequest: one absolute E-clock deadline (UNIT_WAITECLOCK)
+ * standing in for every event in the timer queue */
+static struct MsgPort     *queue_port    = NULL;
+static struct timerequest *queue_treq    = NULL;
+static BOOL queue_pending = FALSE;
+static struct EClockVal queue_when;    /* Deadline of the request out */
+
+/* Timer queue: one deadline per CLOCK_EV_* event */
+typedef struct {
+    struct EClockVal when;             /* Absolute E-clock deadline */
+    ClockEventFn     fn;
+    BOOL             armed;
+    BOOL             have_when;        /* when holds the last deadline */
+} ClockEvent;
+
+static ClockEvent events[CLOCK_EVENTS];
+
+/* Slew state */
+static BOOL slew_active = FALSE;
+static LONG slew_left_us = 0;          /* Correction still to apply */
+static LONG slew_step_us = 0;          /* Largest step per tick */
 
-/* Tracks whether an asynchronous timer request is outstanding */
-static BOOL timer_pending = FALSE;
+/* Battery clock write-back */
+static BOOL  batt_written = FALSE;     /* Written this session */
+static ULONG batt_last = 0;            /* System time of the last write */
+
+/* E-clock timestamps: system time = anchor + E-clock ticks since */
+static BOOL  ec_valid = FALSE;         /* Anchor set */
+static ULONG ec_nominal = 0;           /* Ticks per second, ReadEClock() */
+static ULONG ec_rate = 0;              /* Measured ticks per system second */
+static struct EClockVal ec_anchor;
+static ULONG anchor_secs, anchor_micro;
+static BOOL  ref_valid = FALSE;        /* Rate measurement running */
+static struct EClockVal ec_ref;
+static ULONG ref_secs, ref_micro;
+static LONG  ref_shift_us = 0;         /* Clock sets since ec_ref */
+
+/* UTC timebase: local time minus UTC that the clock carries */
+static LONG  utc_offset = 0;
+
+/* UTC timeline: UTC = utc_base + E-clock ticks since utc_ec */
+static BOOL  utc_valid = FALSE;        /* Anchored */
+static struct EClockVal utc_ec;
+static ULONG utc_base_secs, utc_base_micro;
+static ULONG utc_last_secs, utc_last_micro;  /* Last value handed out */
+
+/* Jump detector */
+static BOOL  jump_seen = FALSE;        /* Found by ec_anchor_now() */
+static BOOL  batt_base_valid = FALSE;
+static LONG  batt_base = 0;            /* System minus battery clock, s */
+static struct EClockVal jump_checked;  /* Last clock_check_jump() */
 
 /* --------------------------------------------------------------------------
  * clock_init - Open timer.device and set up both timerequests
@@ -48,20 +120,36 @@ BOOL clock_init(void)
     /* 4. Set TimerBase so proto/timer.h functions work */
     TimerBase = (struct Device *)main_treq->tr_node.io_Device;
 
-    /* 5. Create periodic message port */
-    periodic_port = CreateMsgPort();
-    if (!periodic_port)
+    /* E-clock starts at its nominal rate until measured */
+    ec_nominal = ReadEClock(&ec_anchor);
+    ec_rate = ec_nominal;
+    ec_valid = FALSE;
+    ref_valid = FALSE;
+
+    /* Optional: A500/A2000 without a clock board have none */
+    BattClockBase = OpenResource(BATTCLOCKNAME);
+
+    /* 5. Create queue message port */
+    queue_port = CreateMsgPort();
+    if (!queue_port)
         goto fail;
 
-    /* 6. Create periodic timerequest */
-    periodic_treq = (struct timerequest *)
-        CreateIORequest(periodic_port, sizeof(struct timerequest));
-    if (!periodic_treq)
+    /* 6. Create queue timerequest */
+    queue_treq = (struct timerequest *)
+        CreateIORequest(queue_port, sizeof(struct timerequest));
+    if (!queue_treq)
         goto fail;
 
-    /* 7. Copy device info from main treq so both share the device */
-    periodic_treq->tr_node.io_Device = main_treq->tr_node.io_Device;
-    periodic_treq->tr_node.io_Unit   = main_treq->tr_node.io_Unit;
+    /* 7. Open it on UNIT_WAITECLOCK: deadlines are E-clock counts, so
+     * setting the system clock does not move them */
+    err = OpenDevice("timer.device", UNIT_WAITECLOCK,
+                     (struct IORequest *)queue_treq, 0);
+    if (err != 0) {
+        queue_treq->tr_node.io_Device = NULL;
+        goto fail;
+    }
+
+    memset(events, 0, sizeof(events));
 
     return TRUE;
 
@@ -76,27 +164,34 @@ fail:
 
 void clock_cleanup(void)
 {
-    /* 1. If a timer is pending, abort and wait for it */
-    if (timer_pending && periodic_treq) {
-        AbortIO((struct IORequest *)periodic_treq);
-        WaitIO((struct IORequest *)periodic_treq);
-        timer_pending = FALSE;
+    /* 1. If the queue request is out, abort and wait for it */
+    if (queue_pending && queue_treq) {
+        AbortIO((struct IORequest *)queue_treq);
+        WaitIO((struct IORequest *)queue_treq);
+        queue_pending = FALSE;
     }
+    memset(events, 0, sizeof(events));
+    slew_active = FALSE;
+    slew_left_us = 0;
 
-    /* 2. Close the device (only once via main_treq) */
+    /* 2. Close the device, once per timerequest that opened it */
+    if (queue_treq && queue_treq->tr_node.io_Device) {
+        CloseDevice((struct IORequest *)queue_treq);
+        queue_treq->tr_node.io_Device = NULL;
+    }
     if (main_treq && main_treq->tr_node.io_Device) {
         CloseDevice((struct IORequest *)main_treq);
         main_treq->tr_node.io_Device = NULL;
     }
 
-    /* 3. Free periodic timerequest and port */
-    if (periodic_treq) {
-        DeleteIORequest((struct IORequest *)periodic_treq);
-        periodic_treq = NULL;
+    /* 3. Free queue timerequest and port */
+    if (queue_treq) {
+        DeleteIORequest((struct IORequest *)queue_treq);
+        queue_treq = NULL;
     }
-    if (periodic_port) {
-        DeleteMsgPort(periodic_port);
-        periodic_port = NULL;
+    if (queue_port) {
+        DeleteMsgPort(queue_port);
+        queue_port = NULL;
     }
 
     /* 4. Free main timerequest and port */
@@ -111,24 +206,226 @@ void clock_cleanup(void)
 
     /* 5. Clear TimerBase */
     TimerBase = NULL;
+    BattClockBase = NULL;
+    ec_valid = FALSE;
 }
 
 /* --------------------------------------------------------------------------
- * clock_set_system_time - Set the Amiga system clock (synchronous)
+ * E-clock timestamps
+ *
+ * UNIT_VBLANK only counts in whole frames (20ms PAL, 16.7ms NTSC),
+ * far too coarse to time a LAN round trip, and every TR_GETSYSTIME is
+ * a DoIO() of its own. Timestamps are read from the E-clock instead
+ * (ReadEClock(), about 709kHz PAL / 716kHz NTSC, no I/O) and turned
+ * into system time through an anchor: a system time and the E-clock
+ * count at that moment.
+ *
+ * Setting the clock re-anchors exactly. Otherwise the anchor is
+ * refreshed from TR_GETSYSTIME every EC_ANCHOR_SECS, and each
+ * EC_RATE_SECS the E-clock is calibrated: its tick rate is measured
+ * against the system clock (less our own sets), since on emulators
+ * and some accelerators the two do not run from the same crystal.
  * -------------------------------------------------------------------------- */
 
-BOOL clock_set_system_time(ULONG amiga_secs, ULONG amiga_micro)
+/* Helper: E-clock ticks from a to b; FALSE if that needs over 32 bits */
+static BOOL ec_ticks(const struct EClockVal *a, const struct EClockVal *b,
+                     ULONG *ticks)
+{
+    ULONG hi = b->ev_hi - a->ev_hi;
+
+    if (b->ev_lo < a->ev_lo)
+        hi--;
+    *ticks = b->ev_lo - a->ev_lo;
+    return (hi == 0) ? TRUE : FALSE;
+}
+
+/* Helper: is a before b? */
+static BOOL ec_before(const struct EClockVal *a, const struct EClockVal *b)
 {
+    if (a->ev_hi != b->ev_hi)
+        return (a->ev_hi < b->ev_hi) ? TRUE : FALSE;
+    return (a->ev_lo < b->ev_lo) ? TRUE : FALSE;
+}
+
+/* Helper: advance secs/micro by a number of E-clock ticks */
+static void ec_add(ULONG ticks, ULONG *secs, ULONG *micro)
+{
+    ULONG rem, a, m;
+
+    /* rem * 10^6 / ec_rate in two steps of 1000, so that nothing
+     * overflows 32 bits while ec_rate stays below 4MHz */
+    rem = ticks % ec_rate;
+    a = rem * 1000;
+    m = (a / ec_rate) * 1000 + ((a % ec_rate) * 1000) / ec_rate;
+
+    *secs  += ticks / ec_rate;
+    *micro += m;
+    if (*micro >= 1000000UL) {
+        *micro -= 1000000UL;
+        (*secs)++;
+    }
+}
+
+/* Helper: system time reached ticks after the anchor */
+static void ec_to_time(ULONG ticks, ULONG *secs, ULONG *micro)
+{
+    *secs  = anchor_secs;
+    *micro = anchor_micro;
+    ec_add(ticks, secs, micro);
+}
+
+/* Helper: a - b in microseconds, clamped to about +/-2000 seconds */
+static LONG time_diff_us(ULONG a_secs, ULONG a_micro,
+                         ULONG b_secs, ULONG b_micro)
+{
+    LONG ds = (LONG)(a_secs - b_secs);
+
+    if (ds > 2000)
+        return 2000000000L;
+    if (ds < -2000)
+        return -2000000000L;
+    return ds * 1000000L + (LONG)a_micro - (LONG)b_micro;
+}
+
+/* Helper: re-anchor to TR_GETSYSTIME, and measure the E-clock rate
+ * once EC_RATE_SECS have passed since the last measurement */
+static void ec_anchor_now(void)
+{
+    struct EClockVal before, after;
+    ULONG secs, micro, ticks, p_secs, p_micro, meas, span_ms;
+    LONG span_us, slack_us;
+
+    ReadEClock(&before);
+    if (!clock_get_system_time(&secs, &micro))
+        return;
+    ReadEClock(&after);
+
+    /* The system time was read about halfway between the two */
+    if (!ec_ticks(&before, &after, &ticks))
+        ticks = 0;
+    after.ev_lo = before.ev_lo + ticks / 2;
+    after.ev_hi = before.ev_hi + ((after.ev_lo < before.ev_lo) ? 1 : 0);
+
+    /* Clock moved behind our back (another program set it)? Far
+     * enough, or the E-clock going back (snapshot restored), is a
+     * jump for clock_check_jump() */
+    if (ec_valid && ec_ticks(&ec_anchor, &after, &ticks)) {
+        ec_to_time(ticks, &p_secs, &p_micro);
+        span_us = time_diff_us(secs, micro, p_secs, p_micro);
+        if (span_us > EC_MAX_SLIP_US || span_us < -EC_MAX_SLIP_US)
+            ref_valid = FALSE;
+        slack_us = JUMP_US +
+                   (LONG)(ticks / ec_rate) * (1000000L / JUMP_RATE_DIV);
+        if (span_us > slack_us || span_us < -slack_us)
+            jump_seen = TRUE;
+    } else if (ec_valid && ec_before(&after, &ec_anchor)) {
+        ref_valid = FALSE;
+        jump_seen = TRUE;
+    }
+
+    /* Rate: E-clock ticks per second of free-running system clock */
+    if (ref_valid && ec_ticks(&ec_ref, &after, &ticks)) {
+        span_us = time_diff_us(secs, micro, ref_secs, ref_micro) -
+                  ref_shift_us;
+        if (ticks >= EC_RATE_SECS * ec_rate) {
+            span_ms = (span_us > 1000) ? (ULONG)span_us / 1000 : 1;
+            meas = (ticks / span_ms) * 1000 +
+                   ((ticks % span_ms) * 1000) / span_ms;
+
+            /* Further than 1% off nominal is a glitch, not a rate */
+            if (meas > ec_nominal - ec_nominal / 100 &&
+                meas < ec_nominal + ec_nominal / 100)
+                ec_rate = (ULONG)((LONG)ec_rate +
+                                  ((LONG)meas - (LONG)ec_rate) / 4);
+            ref_valid = FALSE;
+        }
+    } else {
+        ref_valid = FALSE;
+    }
+
+    ec_anchor = after;
+    anchor_secs = secs;
+    anchor_micro = micro;
+    ec_valid = TRUE;
+
+    if (!ref_valid) {
+        ec_ref = after;
+        ref_secs = secs;
+        ref_micro = micro;
+        ref_shift_us = 0;
+        ref_valid = TRUE;
+    }
+}
+
+/* Helper: set the clock; if at is given, amiga_secs/micro is the time
+ * it should have read then, and the E-clock time since is added */
+static BOOL set_time(ULONG amiga_secs, ULONG amiga_micro,
+                     const struct EClockVal *at)
+{
+    struct EClockVal now;
+    ULONG ticks, p_secs, p_micro;
+    LONG shift;
+
     if (!main_treq)
         return FALSE;
 
+    ReadEClock(&now);
+    if (at && ec_ticks(at, &now, &ticks))
+        ec_add(ticks, &amiga_secs, &amiga_micro);
+
     main_treq->tr_node.io_Command = TR_SETSYSTIME;
     main_treq->tr_time.tv_secs    = amiga_secs;
     main_treq->tr_time.tv_micro   = amiga_micro;
 
     DoIO((struct IORequest *)main_treq);
 
-    return (main_treq->tr_node.io_Error == 0) ? TRUE : FALSE;
+    if (main_treq->tr_node.io_Error != 0)
+        return FALSE;
+
+    /* Keep the rate measurement going across our own sets, as long
+     * as they are small corrections rather than steps */
+    if (ec_valid && ref_valid && ec_ticks(&ec_anchor, &now, &ticks)) {
+        ec_to_time(ticks, &p_secs, &p_micro);
+        shift = time_diff_us(amiga_secs, amiga_micro, p_secs, p_micro);
+        if (shift > -1000000L && shift < 1000000L)
+            ref_shift_us += shift;
+        else
+            ref_valid = FALSE;
+    } else {
+        ref_valid = FALSE;
+    }
+
+    ec_anchor = now;
+    anchor_secs = amiga_secs;
+    anchor_micro = amiga_micro;
+    ec_valid = TRUE;
+    batt_base_valid = FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------
+ * clock_set_system_time - Set the Amiga system clock (synchronous)
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_set_system_time(ULONG amiga_secs, ULONG amiga_micro)
+{
+    return set_time(amiga_secs, amiga_micro, NULL);
+}
+
+/* --------------------------------------------------------------------------
+ * clock_set_time_at - Set the clock to what it should have read at a
+ *                     past reading, plus the time gone by since
+ *
+ * The elapsed time is taken from the E-clock right before
+ * TR_SETSYSTIME, so whatever ran between the reading and the set
+ * (filtering, DST math, a busy GUI) does not end up as clock error.
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_set_time_at(ULONG amiga_secs, ULONG amiga_micro,
+                       const ClockStamp *at)
+{
+    return set_time(amiga_secs, amiga_micro, at ? &at->ec : NULL);
 }
 
 /* --------------------------------------------------------------------------
@@ -153,6 +450,149 @@ BOOL clock_get_system_time(ULONG *amiga_secs, ULONG *amiga_micro)
     return FALSE;
 }
 
+/* --------------------------------------------------------------------------
+ * clock_get_precise_time - Read the system clock at E-clock resolution
+ *
+ * Cheap enough to call right around a send or receive: usually just a
+ * ReadEClock() and some arithmetic.
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_get_precise_time(ClockStamp *t)
+{
+    struct EClockVal now;
+    ULONG ticks, since_ref;
+
+    if (!TimerBase || !t)
+        return FALSE;
+
+    /* Frequent sets (slewing) keep the anchor fresh; the rate is
+     * still due for a measurement every EC_RATE_SECS */
+    ReadEClock(&now);
+    if (!ref_valid || !ec_ticks(&ec_ref, &now, &since_ref))
+        since_ref = 0;
+    if (!ec_valid || !ec_ticks(&ec_anchor, &now, &ticks) ||
+        ticks >= EC_ANCHOR_SECS * ec_rate ||
+        since_ref >= EC_RATE_SECS * ec_rate) {
+        ec_anchor_now();
+        if (!ec_valid)
+            return FALSE;
+        t->secs = anchor_secs;
+        t->micro = anchor_micro;
+        t->ec = ec_anchor;
+        return TRUE;
+    }
+
+    ec_to_time(ticks, &t->secs, &t->micro);
+    t->ec = now;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------
+ * UTC timebase
+ *
+ * The system clock holds local time and jumps by an hour at each DST
+ * change. Schedules, timeouts and statistics run on UTC instead: a
+ * timeline of its own, anchored to the corrected time at each sync
+ * (clock_anchor_utc()) and advanced by the E-clock alone in between.
+ * Our own steps and slews, DST shifts and a clock set by another
+ * program do not move it; only a sync does. Between syncs it never
+ * goes backwards, even if the E-clock does (snapshot restored).
+ *
+ * utc_offset is the zone offset the system clock was last set to
+ * carry, which main.c declares at each sync and DST shift; NTP
+ * timestamps, which must match the system clock, use it instead.
+ * Until the first sync the timeline starts from the system clock less
+ * that offset.
+ * -------------------------------------------------------------------------- */
+
+/* clock_set_utc_offset: the clock now carries local = UTC + offset_secs */
+void clock_set_utc_offset(LONG offset_secs)
+{
+    utc_offset = offset_secs;
+}
+
+/* clock_utc_offset: local minus UTC the clock carries, seconds */
+LONG clock_utc_offset(void)
+{
+    return utc_offset;
+}
+
+/* clock_anchor_utc: UTC was utc_secs/utc_micro at E-clock count at
+ * (a sync's corrected time at its receipt) */
+void clock_anchor_utc(ULONG utc_secs, ULONG utc_micro,
+                      const struct EClockVal *at)
+{
+    utc_ec = *at;
+    utc_base_secs = utc_secs;
+    utc_base_micro = utc_micro;
+
+    /* Should the E-clock go back before the next read, resume from the
+     * anchor rather than from 0 */
+    utc_last_secs = utc_secs;
+    utc_last_micro = utc_micro;
+    utc_valid = TRUE;
+}
+
+/* clock_get_utc: current UTC, seconds since the Amiga epoch */
+BOOL clock_get_utc(ULONG *utc_secs, ULONG *utc_micro)
+{
+    ClockStamp now;
+    struct EClockVal ec;
+    ULONG ticks, secs, micro;
+
+    if (!utc_secs || !utc_micro || !TimerBase)
+        return FALSE;
+
+    if (!utc_valid) {
+        if (!clock_get_precise_time(&now))
+            return FALSE;
+        clock_anchor_utc((ULONG)((LONG)now.secs - utc_offset), now.micro,
+                         &now.ec);
+    }
+
+    ReadEClock(&ec);
+    if (ec_before(&ec, &utc_ec)) {
+        /* E-clock went back: carry on from the last value */
+        utc_ec = ec;
+        utc_base_secs = utc_last_secs;
+        utc_base_micro = utc_last_micro;
+    }
+
+    /* Move the anchor up in steps the 32-bit tick count can hold */
+    while (!ec_ticks(&utc_ec, &ec, &ticks) ||
+           ticks >= EC_ANCHOR_SECS * ec_rate) {
+        if (!ec_ticks(&utc_ec, &ec, &ticks))
+            ticks = 0x40000000UL;
+        ec_add(ticks, &utc_base_secs, &utc_base_micro);
+        utc_ec.ev_lo += ticks;
+        if (utc_ec.ev_lo < ticks)
+            utc_ec.ev_hi++;
+    }
+
+    secs = utc_base_secs;
+    micro = utc_base_micro;
+    ec_add(ticks, &secs, &micro);
+
+    /* A new E-clock rate must not turn it back either */
+    if (secs < utc_last_secs ||
+        (secs == utc_last_secs && micro < utc_last_micro)) {
+        secs = utc_last_secs;
+        micro = utc_last_micro;
+    }
+    utc_last_secs = secs;
+    utc_last_micro = micro;
+
+    *utc_secs = secs;
+    *utc_micro = micro;
+    return TRUE;
+}
+
+/* clock_utc_to_local: local time for a UTC time, at the current offset */
+ULONG clock_utc_to_local(ULONG utc_secs)
+{
+    return (ULONG)((LONG)utc_secs + utc_offset);
+}
+
 /* --------------------------------------------------------------------------
  * clock_format_time - Format Amiga time as human-readable "date time" string
  * -------------------------------------------------------------------------- */
@@ -201,77 +641,451 @@ void clock_format_time(ULONG amiga_secs, char *buf, ULONG buf_size)
 }
 
 /* --------------------------------------------------------------------------
- * clock_start_timer - Start (or restart) the periodic async timer
+ * Timer queue
+ *
+ * Every timed event (the next sync, discipline ticks, slew steps) is a
+ * CLOCK_EV_* slot holding an absolute E-clock deadline and a callback.
+ * Only the earliest deadline is ever queued with timer.device, on a
+ * single UNIT_WAITECLOCK request; when it fires, clock_run_events()
+ * calls whatever has come due and queues the next one. Deadlines
+ * given with clock_event_next() follow on from the previous one, so
+ * time spent in a sync or in the event loop does not add up to drift.
  * -------------------------------------------------------------------------- */
 
-BOOL clock_start_timer(ULONG seconds)
+/* Helper: advance an E-clock count by ms milliseconds of system time */
+static void ec_add_ms(struct EClockVal *ev, ULONG ms)
+{
+    ULONG secs = ms / 1000;
+    ULONG ticks = ((ms % 1000) * ec_rate) / 1000;
+    ULONG chunk;
+
+    /* secs * ec_rate does not fit 32 bits for long intervals: add it
+     * in pieces of at most 4096 seconds (about 2.9 * 10^9 ticks) */
+    do {
+        chunk = (secs > 4096) ? 4096 : secs;
+        secs -= chunk;
+        ticks += chunk * ec_rate;
+        ev->ev_lo += ticks;
+        if (ev->ev_lo < ticks)
+            ev->ev_hi++;
+        ticks = 0;
+    } while (secs > 0);
+}
+
+/* Helper: queue the earliest armed deadline, unless the request
+ * already out is due no later (a deadline that moved later just
+ * costs one early wakeup) */
+static void queue_rearm(void)
 {
-    if (!periodic_treq)
+    struct EClockVal *first = NULL;
+    ULONG i;
+
+    if (!queue_treq)
+        return;
+
+    for (i = 0; i < CLOCK_EVENTS; i++) {
+        if (events[i].armed &&
+            (first == NULL || ec_before(&events[i].when, first)))
+            first = &events[i].when;
+    }
+    if (first == NULL)
+        return;
+
+    if (queue_pending) {
+        if (!ec_before(first, &queue_when))
+            return;
+        AbortIO((struct IORequest *)queue_treq);
+        WaitIO((struct IORequest *)queue_treq);
+        queue_pending = FALSE;
+    }
+
+    queue_when = *first;
+    queue_treq->tr_node.io_Command = TR_ADDREQUEST;
+    queue_treq->tr_time.tv_secs    = queue_when.ev_hi;
+    queue_treq->tr_time.tv_micro   = queue_when.ev_lo;
+
+    SendIO((struct IORequest *)queue_treq);
+    queue_pending = TRUE;
+}
+
+/* Helper: arm an event for an absolute deadline */
+static BOOL event_arm(ULONG ev, const struct EClockVal *when, ClockEventFn fn)
+{
+    if (ev >= CLOCK_EVENTS || !queue_treq || !fn)
         return FALSE;
 
-    /* If a timer is already pending, abort it first */
-    if (timer_pending) {
-        AbortIO((struct IORequest *)periodic_treq);
-        WaitIO((struct IORequest *)periodic_treq);
-        timer_pending = FALSE;
+    events[ev].when = *when;
+    events[ev].fn = fn;
+    events[ev].armed = TRUE;
+    events[ev].have_when = TRUE;
+    queue_rearm();
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------
+ * clock_event_in - Call fn in ms milliseconds, replacing any deadline
+ *                  the event had
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_event_in(ULONG ev, ULONG ms, ClockEventFn fn)
+{
+    struct EClockVal when;
+
+    if (!TimerBase)
+        return FALSE;
+
+    ReadEClock(&when);
+    ec_add_ms(&when, ms);
+    return event_arm(ev, &when, fn);
+}
+
+/* --------------------------------------------------------------------------
+ * clock_event_next - Call fn ms milliseconds after the event's previous
+ *                    deadline
+ *
+ * Keeps a periodic event on schedule. Falls back to clock_event_in()
+ * if the event has no previous deadline (never armed, or cancelled)
+ * or the new one would already be past.
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_event_next(ULONG ev, ULONG ms, ClockEventFn fn)
+{
+    struct EClockVal now, when;
+
+    if (!TimerBase || ev >= CLOCK_EVENTS)
+        return FALSE;
+
+    if (!events[ev].have_when)
+        return clock_event_in(ev, ms, fn);
+
+    when = events[ev].when;
+    ec_add_ms(&when, ms);
+    ReadEClock(&now);
+    if (ec_before(&when, &now))
+        return clock_event_in(ev, ms, fn);
+
+    return event_arm(ev, &when, fn);
+}
+
+/* --------------------------------------------------------------------------
+ * clock_event_cancel - Disarm an event and forget its deadline
+ * -------------------------------------------------------------------------- */
+
+void clock_event_cancel(ULONG ev)
+{
+    if (ev >= CLOCK_EVENTS)
+        return;
+
+    events[ev].armed = FALSE;
+    events[ev].have_when = FALSE;
+}
+
+/* --------------------------------------------------------------------------
+ * clock_event_pending - TRUE if an event is armed
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_event_pending(ULONG ev)
+{
+    return (ev < CLOCK_EVENTS && events[ev].armed) ? TRUE : FALSE;
+}
+
+/* --------------------------------------------------------------------------
+ * clock_queue_signal - Return the signal mask for the timer queue port
+ * -------------------------------------------------------------------------- */
+
+ULONG clock_queue_signal(void)
+{
+    if (queue_port)
+        return 1UL << queue_port->mp_SigBit;
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * clock_run_events - Call the events that have come due
+ *
+ * Must be called when the queue signal is received. Each due event is
+ * disarmed before its callback runs, so the callback may arm it again;
+ * an event re-armed for a deadline already past runs on the next call.
+ * -------------------------------------------------------------------------- */
+
+void clock_run_events(void)
+{
+    struct EClockVal now;
+    ULONG due = 0;
+    ULONG i;
+
+    if (!queue_port)
+        return;
+
+    if (GetMsg(queue_port) != NULL)
+        queue_pending = FALSE;
+
+    ReadEClock(&now);
+    for (i = 0; i < CLOCK_EVENTS; i++) {
+        if (events[i].armed && !ec_before(&now, &events[i].when)) {
+            events[i].armed = FALSE;
+            due |= 1UL << i;
+        }
+    }
+
+    for (i = 0; i < CLOCK_EVENTS; i++) {
+        if (due & (1UL << i))
+            events[i].fn();
     }
 
-    periodic_treq->tr_node.io_Command = TR_ADDREQUEST;
-    periodic_treq->tr_time.tv_secs    = seconds;
-    periodic_treq->tr_time.tv_micro   = 0;
+    queue_rearm();
+}
 
-    SendIO((struct IORequest *)periodic_treq);
-    timer_pending = TRUE;
+/* --------------------------------------------------------------------------
+ * clock_adjust_time - Move the system clock by a small signed amount
+ *
+ * Reads the clock and sets it delta_us microseconds further, so the
+ * correction does not depend on when the caller last read the time.
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_adjust_time(LONG delta_us)
+{
+    ClockStamp now;
+    ULONG secs;
+    LONG m;
+
+    if (!clock_get_precise_time(&now))
+        return FALSE;
+
+    secs = now.secs;
+    m = (LONG)now.micro + delta_us % 1000000L;
+    secs += delta_us / 1000000L;
+    if (m < 0) {
+        m += 1000000L;
+        secs--;
+    } else if (m >= 1000000L) {
+        m -= 1000000L;
+        secs++;
+    }
+
+    return clock_set_system_time(secs, (ULONG)m);
+}
+
+/* --------------------------------------------------------------------------
+ * Slew engine
+ *
+ * Instead of stepping, a correction can be spread out as one small
+ * clock_adjust_time() per SLEW_TICK_MS, never more than rate_ppm
+ * allows. timer.device has no way to run the clock slower, so each
+ * tick of a negative slew is a TR_SETSYSTIME that sets the clock back
+ * by up to rate_ppm microseconds (500 by default, against the 20 ms
+ * of a DateStamp()). Readers can see that small step backwards; what
+ * slewing avoids is one backward jump by the whole offset.
+ * -------------------------------------------------------------------------- */
+
+/* Helper: apply one slew step, when its tick comes due */
+static void slew_tick(void)
+{
+    LONG step;
+
+    if (!slew_active)
+        return;
+
+    step = slew_left_us;
+    if (step > slew_step_us)
+        step = slew_step_us;
+    else if (step < -slew_step_us)
+        step = -slew_step_us;
+
+    clock_adjust_time(step);
+    slew_left_us -= step;
+
+    if (slew_left_us == 0) {
+        slew_active = FALSE;
+        return;
+    }
+
+    clock_event_next(CLOCK_EV_SLEW, SLEW_TICK_MS, slew_tick);
+}
+
+/* --------------------------------------------------------------------------
+ * clock_slew - Start slewing the clock by offset_us, replacing any
+ *              slew in progress
+ * -------------------------------------------------------------------------- */
+
+BOOL clock_slew(LONG offset_us, ULONG rate_ppm)
+{
+    if (!queue_treq)
+        return FALSE;
+
+    clock_stop_slew();
+
+    /* rate_ppm microseconds per second of real time */
+    slew_step_us = (LONG)(rate_ppm * SLEW_TICK_MS / 1000);
+    if (slew_step_us < 1)
+        slew_step_us = 1;
+    slew_left_us = offset_us;
+
+    if (slew_left_us != 0) {
+        slew_active = TRUE;
+        if (!clock_event_in(CLOCK_EV_SLEW, SLEW_TICK_MS, slew_tick)) {
+            clock_stop_slew();
+            return FALSE;
+        }
+    }
 
     return TRUE;
 }
 
 /* --------------------------------------------------------------------------
- * clock_abort_timer - Safely cancel a pending periodic timer
+ * clock_stop_slew - Abandon the rest of a slew (e.g. before a step)
+ * -------------------------------------------------------------------------- */
+
+void clock_stop_slew(void)
+{
+    clock_event_cancel(CLOCK_EV_SLEW);
+    slew_active = FALSE;
+    slew_left_us = 0;
+}
+
+/* --------------------------------------------------------------------------
+ * clock_slew_remaining - Correction not yet applied, microseconds
+ * -------------------------------------------------------------------------- */
+
+LONG clock_slew_remaining(void)
+{
+    return slew_left_us;
+}
+
+/* --------------------------------------------------------------------------
+ * Battery clock write-back
+ *
+ * After a good sync the corrected time is written to battclock.resource,
+ * so the next boot starts close to right. The hardware clock only
+ * holds whole seconds, so the write is timed (through the timer queue)
+ * to land just after a second boundary of the corrected time; a slew
+ * still in progress counts as already applied.
  * -------------------------------------------------------------------------- */
 
-void clock_abort_timer(void)
+/* Helper: the system time with any remaining slew applied */
+static BOOL batt_now(ClockStamp *t)
+{
+    LONG m;
+
+    if (!clock_get_precise_time(t))
+        return FALSE;
+
+    m = (LONG)t->micro + slew_left_us % 1000000L;
+    t->secs += slew_left_us / 1000000L;
+    if (m < 0) {
+        m += 1000000L;
+        t->secs--;
+    } else if (m >= 1000000L) {
+        m -= 1000000L;
+        t->secs++;
+    }
+    t->micro = (ULONG)m;
+    return TRUE;
+}
+
+static void batt_tick(void);
+
+/* Helper: arm the write for the next second boundary */
+static void batt_arm(const ClockStamp *now)
+{
+    clock_event_in(CLOCK_EV_BATT, (1000000UL - now->micro + 999) / 1000,
+                   batt_tick);
+}
+
+/* Helper: timer queue callback (CLOCK_EV_BATT): write if on time */
+static void batt_tick(void)
 {
-    if (timer_pending && periodic_treq) {
-        AbortIO((struct IORequest *)periodic_treq);
-        WaitIO((struct IORequest *)periodic_treq);
-        timer_pending = FALSE;
+    ClockStamp now;
+
+    if (!BattClockBase || !batt_now(&now))
+        return;
+
+    /* Woke up late (busy system): try the next boundary */
+    if (now.micro >= BATT_SLACK_US) {
+        batt_arm(&now);
+        return;
     }
+
+    WriteBattClock(now.secs);
+    batt_base_valid = FALSE;
+    batt_last = now.secs;
+    batt_written = TRUE;
+    window_log("Battery clock updated");
 }
 
 /* --------------------------------------------------------------------------
- * clock_timer_signal - Return the signal mask for the periodic timer port
+ * clock_battclock_update - Write the time to the battery clock at the
+ *                          next second boundary, unless it was written
+ *                          less than period_secs ago (0 = never)
  * -------------------------------------------------------------------------- */
 
-ULONG clock_timer_signal(void)
+void clock_battclock_update(ULONG period_secs)
 {
-    if (periodic_port)
-        return 1UL << periodic_port->mp_SigBit;
+    ClockStamp now;
 
-    return 0;
+    if (!BattClockBase || period_secs == 0 || !batt_now(&now))
+        return;
+
+    /* Clock stepped back past the last write: that one is stale */
+    if (batt_written && now.secs >= batt_last &&
+        now.secs - batt_last < period_secs)
+        return;
+
+    batt_arm(&now);
 }
 
 /* --------------------------------------------------------------------------
- * clock_check_timer - Check if timer fired and acknowledge it
+ * Jump detector
+ *
+ * An emulator that was paused or restored from a snapshot, or another
+ * program setting the clock, leaves the system time wrong until the
+ * next sync. clock_check_jump() is called on every wakeup of the event
+ * loop and compares the system time with two references:
+ *
+ *  - the E-clock: the system time should be the anchor plus the ticks
+ *    since (checked in ec_anchor_now(), so slips seen while taking
+ *    timestamps count too);
+ *  - the battery clock: a paused emulator stops the E-clock and the
+ *    system clock alike, but its battery clock follows the host, so
+ *    the difference between the two changes.
  *
- * Must be called when timer_signal is received. Returns TRUE if the timer
- * actually completed (vs spurious signal). Clears the pending flag.
+ * Our own clock sets and battery clock writes reset the references.
+ * Wakeups less than a quarter second apart are not checked again, so
+ * a burst of GUI events costs one TR_GETSYSTIME at most.
  * -------------------------------------------------------------------------- */
 
-BOOL clock_check_timer(void)
+BOOL clock_check_jump(void)
 {
-    struct Message *msg;
+    struct EClockVal now;
+    ULONG ticks;
+    LONG d;
+    BOOL jumped;
 
-    if (!periodic_port || !timer_pending)
+    if (!TimerBase)
         return FALSE;
 
-    /* Check if a message is waiting (non-blocking) */
-    msg = GetMsg(periodic_port);
-    if (msg != NULL) {
-        /* Timer completed - don't reply, it's our own IORequest */
-        timer_pending = FALSE;
-        return TRUE;
+    ReadEClock(&now);
+    if (ec_valid && ec_ticks(&jump_checked, &now, &ticks) &&
+        ticks < ec_rate / 4 && !jump_seen)
+        return FALSE;
+    jump_checked = now;
+
+    ec_anchor_now();
+    if (!ec_valid)
+        return FALSE;
+
+    if (BattClockBase) {
+        d = (LONG)(anchor_secs - ReadBattClock());
+        if (batt_base_valid &&
+            (d - batt_base > JUMP_BATT_SECS || batt_base - d > JUMP_BATT_SECS))
+            jump_seen = TRUE;
+        batt_base = d;
+        batt_base_valid = TRUE;
     }
 
-    return FALSE;
+    jumped = jump_seen;
+    jump_seen = FALSE;
+    return jumped;
 }
@@ -29,6 +29,14 @@ static void set_defaults(void)
     current_config.server[i] = '\0';
 
     current_config.interval = DEFAULT_INTERVAL;
+    current_config.burst = DEFAULT_BURST;
+    current_config.burst_spacing = DEFAULT_BURST_SPACING;
+    current_config.dns_ttl = DEFAULT_DNS_TTL;
+    current_config.poll_min = DEFAULT_POLL_MIN;
+    current_config.poll_max = DEFAULT_POLL_MAX;
+    current_config.slew_rate = DEFAULT_SLEW_RATE;
+    current_config.step_threshold = DEFAULT_STEP_THRESHOLD;
+    current_config.battclock = DEFAULT_BATTCLOCK;
 
     for (i = 0; i < (LONG)sizeof(current_config.tz_name) - 1 && tz_src[i] != '\0'; i++)
         current_config.tz_name[i] = tz_src[i];
@@ -144,6 +152,46 @@ static void parse_line(const char *line)
             current_config.interval = val;
         }
 
+    } else if (strncmp(line, "BURST=", 6) == 0) {
+        val = parse_int(line + 6, &ok);
+        if (ok)
+            config_set_burst(val, current_config.burst_spacing);
+
+    } else if (strncmp(line, "BURST_SPACING=", 14) == 0) {
+        val = parse_int(line + 14, &ok);
+        if (ok)
+            config_set_burst(current_config.burst, val);
+
+    } else if (strncmp(line, "DNS_TTL=", 8) == 0) {
+        val = parse_int(line + 8, &ok);
+        if (ok)
+            config_set_dns_ttl(val);
+
+    } else if (strncmp(line, "POLL_MIN=", 9) == 0) {
+        val = parse_int(line + 9, &ok);
+        if (ok)
+            config_set_poll(val, current_config.poll_max);
+
+    } else if (strncmp(line, "POLL_MAX=", 9) == 0) {
+        val = parse_int(line + 9, &ok);
+        if (ok)
+            config_set_poll(current_config.poll_min, val);
+
+    } else if (strncmp(line, "SLEW_RATE=", 10) == 0) {
+        val = parse_int(line + 10, &ok);
+        if (ok)
+            config_set_slew(val, current_config.step_threshold);
+
+    } else if (strncmp(line, "STEP_THRESHOLD=", 15) == 0) {
+        val = parse_int(line + 15, &ok);
+        if (ok)
+            config_set_slew(current_config.slew_rate, val);
+
+    } else if (strncmp(line, "BATTCLOCK=", 10) == 0) {
+        val = parse_int(line + 10, &ok);
+        if (ok)
+            config_set_battclock(val);
+
     } else if (strncmp(line, "TIMEZONE=", 9) == 0) {
         const char *src = line + 9;
         LONG i;
@@ -196,6 +244,50 @@ static BOOL save_to_path(const char *path)
     FPuts(fh, current_config.tz_name);
     FPuts(fh, "\n");
 
+    /* BURST= */
+    FPuts(fh, "BURST=");
+    int_to_str(current_config.burst, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+
+    /* BURST_SPACING= */
+    FPuts(fh, "BURST_SPACING=");
+    int_to_str(current_config.burst_spacing, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+
+    /* DNS_TTL= */
+    FPuts(fh, "DNS_TTL=");
+    int_to_str(current_config.dns_ttl, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+
+    /* POLL_MIN= / POLL_MAX= */
+    FPuts(fh, "POLL_MIN=");
+    int_to_str(current_config.poll_min, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+    FPuts(fh, "POLL_MAX=");
+    int_to_str(current_config.poll_max, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+
+    /* SLEW_RATE= / STEP_THRESHOLD= */
+    FPuts(fh, "SLEW_RATE=");
+    int_to_str(current_config.slew_rate, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+    FPuts(fh, "STEP_THRESHOLD=");
+    int_to_str(current_config.step_threshold, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+
+    /* BATTCLOCK= */
+    FPuts(fh, "BATTCLOCK=");
+    int_to_str(current_config.battclock, buf);
+    FPuts(fh, buf);
+    FPuts(fh, "\n");
+
     Close(fh);
     return TRUE;
 }
@@ -288,3 +380,92 @@ void config_set_tz_name(const char *name)
         current_config.tz_name[i] = name[i];
     current_config.tz_name[i] = '\0';
 }
+
+/* config_set_burst: set burst size and spacing with clamping */
+void config_set_burst(LONG burst, LONG spacing)
+{
+    if (burst < MIN_BURST) burst = MIN_BURST;
+    if (burst > MAX_BURST) burst = MAX_BURST;
+    if (spacing < MIN_BURST_SPACING) spacing = MIN_BURST_SPACING;
+    if (spacing > MAX_BURST_SPACING) spacing = MAX_BURST_SPACING;
+    current_config.burst = burst;
+    current_config.burst_spacing = spacing;
+}
+
+/* config_set_dns_ttl: set DNS cache lifetime with clamping */
+void config_set_dns_ttl(LONG ttl)
+{
+    if (ttl < MIN_DNS_TTL) ttl = MIN_DNS_TTL;
+    if (ttl > MAX_DNS_TTL) ttl = MAX_DNS_TTL;
+    current_config.dns_ttl = ttl;
+}
+
+/* config_set_poll: set adaptive poll bounds, clamped to the interval
+ * limits; a minimum above the maximum is lowered to it */
+void config_set_poll(LONG poll_min, LONG poll_max)
+{
+    if (poll_min < MIN_INTERVAL) poll_min = MIN_INTERVAL;
+    if (poll_min > MAX_INTERVAL) poll_min = MAX_INTERVAL;
+    if (poll_max < MIN_INTERVAL) poll_max = MIN_INTERVAL;
+    if (poll_max > MAX_INTERVAL) poll_max = MAX_INTERVAL;
+    if (poll_min > poll_max) poll_min = poll_max;
+    current_config.poll_min = poll_min;
+    current_config.poll_max = poll_max;
+}
+
+/* config_set_slew: set slew rate limit (ppm) and step threshold (ms)
+ * with clamping */
+void config_set_slew(LONG slew_rate, LONG step_threshold)
+{
+    if (slew_rate < MIN_SLEW_RATE) slew_rate = MIN_SLEW_RATE;
+    if (slew_rate > MAX_SLEW_RATE) slew_rate = MAX_SLEW_RATE;
+    if (step_threshold < MIN_STEP_THRESHOLD) step_threshold = MIN_STEP_THRESHOLD;
+    if (step_threshold > MAX_STEP_THRESHOLD) step_threshold = MAX_STEP_THRESHOLD;
+    current_config.slew_rate = slew_rate;
+    current_config.step_threshold = step_threshold;
+}
+
+/* config_set_battclock: set the battery clock write period with
+ * clamping; 0 turns the write-back off */
+void config_set_battclock(LONG period)
+{
+    if (period < 0) period = 0;
+    if (period > 0 && period < MIN_BATTCLOCK) period = MIN_BATTCLOCK;
+    if (period > MAX_BATTCLOCK) period = MAX_BATTCLOCK;
+    current_config.battclock = period;
+}
+
+/* config_get_servers: split the SERVER= list into individual host names
+ *
+ * Names are separated by spaces or commas. Copies up to max names into
+ * names[] and returns how many were found.
+ */
+ULONG config_get_servers(char names[][SERVER_NAME_MAX], ULONG max)
+{
+    const char *src = current_config.server;
+    ULONG count = 0;
+    LONG i;
+
+    while (*src && count < max) {
+        /* Skip separators */
+        while (*src == ' ' || *src == ',' || *src == '\t')
+            src++;
+        if (*src == '\0')
+            break;
+
+        for (i = 0; i < SERVER_NAME_MAX - 1 &&
+                    src[i] != '\0' && src[i] != ' ' &&
+                    src[i] != ',' && src[i] != '\t'; i++)
+            names[count][i] = src[i];
+        names[count][i] = '\0';
+        src += i;
+
+        /* Skip the rest of an overlong name */
+        while (*src && *src != ' ' && *src != ',' && *src != '\t')
+            src++;
+
+        count++;
+    }
+
+    return count;
+}
@@ -0,0 +1,254 @@
+/* discipline.c - Clock frequency discipline for SyncTime
+ *
+ * The Amiga system clock free-runs between syncs, and depending on
+ * the board (PAL/NTSC VBLANK, accelerator, emulator) it gains or
+ * loses tens of ppm. Each sync measures how far the clock has drifted
+ * since the previous one; dividing by the time between them gives
+ * the remaining frequency error, which is folded into a running
+ * estimate as NTP's hybrid loop does (RFC 5905 section 11.3): half
+ * the error per update over long intervals (FLL), a quarter over
+ * short ones, where phase noise dominates (PLL-like damping).
+ *
+ * Between syncs the estimate is applied as a steady stream of ~1ms
+ * corrections paced by clock.c's timer queue, so the clock keeps
+ * predicting the right time while the network is down (holdover).
+ * discipline_error_bound() says how far off it may have wandered by
+ * now.
+ *
+ * Frequencies are in ppb (ns per second), positive when the clock
+ * runs slow and time has to be added.
+ */
+
+#include "synctime.h"
+
+/* Frequency estimate limit: +/-500 ppm */
+#define DISC_MAX_FREQ      500000L
+
+/* Shortest gap between syncs worth a frequency measurement, seconds */
+#define DISC_MIN_DT        64
+
+/* Gap from which the FLL gain applies, seconds */
+#define DISC_FLL_DT        1024
+
+/* Larger offsets are a step or a glitch, not drift, microseconds */
+#define DISC_MAX_OFFSET    128000L
+
+/* Adjust in steps of about this much, microseconds */
+#define DISC_STEP_US       1000L
+
+/* Adjust timer bounds, milliseconds */
+#define DISC_MIN_TICK_MS   1000UL
+#define DISC_MAX_TICK_MS   600000UL
+
+/* Frequency uncertainty floor for the holdover bound: 1 ppm */
+#define DISC_MIN_WANDER    1000UL
+
+/* =========================================================================
+ * Static module state
+ * ========================================================================= */
+
+static LONG  freq       = 0;          /* Estimated correction, ppb */
+static BOOL  have_freq  = FALSE;      /* freq holds a measurement */
+static ULONG wander     = 0;          /* Average |frequency error|, ppb */
+static BOOL  have_ref   = FALSE;
+static ULONG ref_secs   = 0;          /* Corrected UTC of the last sync */
+static ULONG sync_err   = 0;          /* Error bound at the last sync, us */
+static ULONG tick_secs, tick_micro;   /* Time of the last correction */
+static LONG  residue_ns = 0;          /* Correction not yet applied */
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+/* Helper: milliseconds until ~DISC_STEP_US has accumulated */
+static ULONG tick_ms(void)
+{
+    ULONG f = (freq < 0) ? (ULONG)-freq : (ULONG)freq;
+    ULONG ms;
+
+    if (f == 0)
+        return DISC_MAX_TICK_MS;
+
+    /* DISC_STEP_US * 10^6 ns / f ppb, in ms */
+    ms = (ULONG)(DISC_STEP_US * 1000000L) / f;
+    if (ms < DISC_MIN_TICK_MS)
+        ms = DISC_MIN_TICK_MS;
+    if (ms > DISC_MAX_TICK_MS)
+        ms = DISC_MAX_TICK_MS;
+    return ms;
+}
+
+/* Helper: restart the pacing of corrections from the current time */
+static void restart_ticks(void)
+{
+    clock_get_utc(&tick_secs, &tick_micro);
+    residue_ns = 0;
+
+    if (have_freq && freq != 0)
+        clock_event_in(CLOCK_EV_ADJUST, tick_ms(), discipline_tick);
+    else
+        clock_event_cancel(CLOCK_EV_ADJUST);
+}
+
+/* Helper: append "+12.345 ppm" style frequency to p */
+static char *append_ppm(char *p, LONG ppb)
+{
+    char tmp[12];
+    ULONG val;
+    int i = 0, digits = 0;
+
+    if (ppb < 0) {
+        *p++ = '-';
+        val = (ULONG)-ppb;
+    } else {
+        *p++ = '+';
+        val = (ULONG)ppb;
+    }
+
+    do {
+        tmp[i++] = '0' + (char)(val % 10);
+        val /= 10;
+        if (++digits == 3)
+            tmp[i++] = '.';
+    } while (val > 0 || digits < 4);
+
+    while (i > 0)
+        *p++ = tmp[--i];
+    strcpy(p, " ppm");
+    return p + 4;
+}
+
+/* =========================================================================
+ * Public API
+ * ========================================================================= */
+
+/*
+ * discipline_update - Learn from a sync and restart holdover from it
+ *
+ * offset_us is the correction the sync applied, err_us its error
+ * bound (root distance), now_secs the corrected UTC just after it
+ * was applied.
+ */
+void discipline_update(LONG offset_us, ULONG err_us, ULONG now_secs)
+{
+    char msg[48];
+    ULONG dt, mag;
+    LONG residual;
+
+    mag = (offset_us < 0) ? (ULONG)-offset_us : (ULONG)offset_us;
+
+    if (have_ref && now_secs >= ref_secs + DISC_MIN_DT &&
+        mag <= (ULONG)DISC_MAX_OFFSET) {
+        dt = now_secs - ref_secs;
+        residual = (offset_us * 1000L) / (LONG)dt;
+        if (residual > DISC_MAX_FREQ) residual = DISC_MAX_FREQ;
+        if (residual < -DISC_MAX_FREQ) residual = -DISC_MAX_FREQ;
+        mag = (residual < 0) ? (ULONG)-residual : (ULONG)residual;
+
+        if (!have_freq) {
+            freq += residual;
+            wander = mag;
+        } else {
+            freq += (dt >= DISC_FLL_DT) ? residual / 2 : residual / 4;
+            wander = wander - wander / 4 + mag / 4;
+        }
+        if (freq > DISC_MAX_FREQ) freq = DISC_MAX_FREQ;
+        if (freq < -DISC_MAX_FREQ) freq = -DISC_MAX_FREQ;
+        have_freq = TRUE;
+
+        strcpy(msg, "Frequency correction ");
+        append_ppm(msg + 21, freq);
+        window_log(msg);
+    }
+
+    have_ref = TRUE;
+    ref_secs = now_secs;
+    sync_err = err_us;
+    restart_ticks();
+}
+
+/*
+ * discipline_tick - Apply the correction accumulated since the last tick
+ *
+ * Timer queue callback (CLOCK_EV_ADJUST); re-arms itself.
+ */
+void discipline_tick(void)
+{
+    ULONG secs, micro, ms;
+    LONG ns, us;
+
+    if (!have_freq)
+        return;
+
+    clock_get_utc(&secs, &micro);
+    if (secs < tick_secs || secs - tick_secs > DISC_MAX_TICK_MS / 1000 * 2) {
+        /* Clock was set behind our back: just start over */
+        restart_ticks();
+        return;
+    }
+    ms = (secs - tick_secs) * 1000 + micro / 1000 - tick_micro / 1000;
+
+    /* freq * ms / 1000 without overflowing: |freq| < 2^19, ms < 2^21 */
+    ns = freq * (LONG)(ms / 1000) + (freq * (LONG)(ms % 1000)) / 1000;
+    residue_ns += ns;
+    us = residue_ns / 1000;
+    residue_ns -= us * 1000;
+
+    if (us != 0)
+        clock_adjust_time(us);
+
+    clock_get_utc(&tick_secs, &tick_micro);
+    clock_event_next(CLOCK_EV_ADJUST, tick_ms(), discipline_tick);
+}
+
+/* discipline_stop: stop applying corrections (commodity disabled) */
+void discipline_stop(void)
+{
+    clock_event_cancel(CLOCK_EV_ADJUST);
+}
+
+/*
+ * discipline_error_bound - Estimated clock error now, microseconds
+ *
+ * The error bound of the last sync plus the frequency uncertainty
+ * accumulated since. Returns 0xFFFFFFFF before the first sync.
+ */
+ULONG discipline_error_bound(void)
+{
+    ULONG secs, micro, elapsed, w;
+
+    if (!have_ref)
+        return 0xFFFFFFFFUL;
+
+    clock_get_utc(&secs, &micro);
+    elapsed = (secs > ref_secs) ? secs - ref_secs : 0;
+    if (elapsed > 1000000UL)
+        elapsed = 1000000UL;
+
+    w = (have_freq ? wander : DISC_MAX_FREQ) + DISC_MIN_WANDER;
+
+    /* w ppb * elapsed s in us, split to stay within 32 bits */
+    return sync_err + (w / 1000) * elapsed + ((w % 1000) * elapsed) / 1000;
+}
+
+/* discipline_get_freq: current frequency correction and its average
+ * error (wander), ppb; FALSE if nothing has been measured yet */
+BOOL discipline_get_freq(LONG *ppb, ULONG *wander_ppb)
+{
+    *ppb = freq;
+    *wander_ppb = wander;
+    return have_freq;
+}
+
+/* discipline_set_freq: restore a saved estimate (state.c). It is used
+ * from the first sync on, like a measured one. */
+void discipline_set_freq(LONG ppb, ULONG wander_ppb)
+{
+    if (ppb > DISC_MAX_FREQ) ppb = DISC_MAX_FREQ;
+    if (ppb < -DISC_MAX_FREQ) ppb = -DISC_MAX_FREQ;
+    if (wander_ppb > (ULONG)DISC_MAX_FREQ) wander_ppb = DISC_MAX_FREQ;
+
+    freq = ppb;
+    wander = wander_ppb;
+    have_freq = TRUE;
+}
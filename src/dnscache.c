@@ -0,0 +1,372 @@
+/* dnscache.c - DNS answer cache for SyncTime
+ *
+ * Keeps every address a host name resolved to, so a pool name such as
+ * pool.ntp.org is looked up once per DNS_TTL seconds instead of once
+ * per sync. Each lookup hands out the next address in turn; addresses
+ * that repeatedly fail to answer are skipped, and once all of a name's
+ * addresses are demoted the name is resolved again.
+ *
+ * Known-good addresses are saved to ENV: and ENVARC: (like config.c,
+ * one "name addr addr ..." line per host), so the first sync after a
+ * reboot, when DNS is slowest and most likely to fail, can skip it.
+ * ENV: is in RAM and rewritten whenever the set changes; the ENVARC:
+ * copy is only written with state.c's batched writes, since pool names
+ * answer with a different set on most lookups.
+ */
+
+#include "synctime.h"
+
+/* Names cached: one per server slot is all a sync can use */
+#define DNS_CACHE_SIZE     MAX_SERVERS
+
+/* Missed replies before an address is skipped */
+#define DNS_MAX_FAILS      2
+
+/* =========================================================================
+ * Static module state
+ * ========================================================================= */
+
+typedef struct {
+    char  name[SERVER_NAME_MAX];      /* Empty = unused */
+    ULONG addrs[DNS_MAX_ADDRS];       /* Network byte order */
+    UBYTE fails[DNS_MAX_ADDRS];       /* Consecutive missed replies */
+    UBYTE count;
+    UBYTE next;                       /* Rotation position */
+    ULONG expires;                    /* UTC seconds */
+} DNSEntry;
+
+static DNSEntry cache[DNS_CACHE_SIZE];
+static BOOL     dirty = FALSE;        /* Known-good set changed since ENV: save */
+static BOOL     arc_dirty = FALSE;    /* ... since ENVARC: save */
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+/* Helper: current UTC in seconds */
+static ULONG now_secs(void)
+{
+    ULONG secs, micro;
+
+    clock_get_utc(&secs, &micro);
+    return secs;
+}
+
+/* Helper: find the entry for a name, or NULL */
+static DNSEntry *find_entry(const char *name)
+{
+    LONG i;
+
+    for (i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (cache[i].name[0] != '\0' && strcmp(cache[i].name, name) == 0)
+            return &cache[i];
+    }
+    return NULL;
+}
+
+/* Helper: entry to (re)use for a name: its own, a free one, or the
+ * one closest to expiry */
+static DNSEntry *claim_entry(const char *name)
+{
+    DNSEntry *e = find_entry(name);
+    LONG i;
+
+    if (e != NULL)
+        return e;
+
+    e = &cache[0];
+    for (i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (cache[i].name[0] == '\0')
+            return &cache[i];
+        if (cache[i].expires < e->expires)
+            e = &cache[i];
+    }
+    return e;
+}
+
+/* Helper: fill an entry with a fresh set of addresses */
+static void set_entry(DNSEntry *e, const char *name, const ULONG *addrs,
+                      ULONG count, ULONG expires)
+{
+    LONG i;
+
+    for (i = 0; i < SERVER_NAME_MAX - 1 && name[i] != '\0'; i++)
+        e->name[i] = name[i];
+    e->name[i] = '\0';
+
+    if (count > DNS_MAX_ADDRS)
+        count = DNS_MAX_ADDRS;
+    for (i = 0; i < (LONG)count; i++) {
+        e->addrs[i] = addrs[i];
+        e->fails[i] = 0;
+    }
+    e->count = (UBYTE)count;
+    e->next = 0;
+    e->expires = expires;
+}
+
+/* Helper: TRUE if an entry already holds exactly this address set, all
+ * of it known-good, so storing it again would not change the saved set */
+static BOOL same_addrs(const DNSEntry *e, const ULONG *addrs, ULONG count)
+{
+    LONG i, j;
+
+    if (count > DNS_MAX_ADDRS)
+        count = DNS_MAX_ADDRS;
+    if (e->count != count)
+        return FALSE;
+
+    for (i = 0; i < (LONG)count; i++) {
+        for (j = 0; j < e->count; j++) {
+            if (e->addrs[j] == addrs[i])
+                break;
+        }
+        if (j == e->count || e->fails[j] >= DNS_MAX_FAILS)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Helper: parse a dotted-quad address (manual, no inet_addr), advancing
+ * *s past it. Returns FALSE if *s does not start with one. */
+static BOOL parse_addr(const char **s, ULONG *ip_addr)
+{
+    UBYTE *ip = (UBYTE *)ip_addr;
+    const char *p = *s;
+    ULONG val;
+    int i, digits;
+
+    for (i = 0; i < 4; i++) {
+        if (i > 0) {
+            if (*p != '.')
+                return FALSE;
+            p++;
+        }
+        val = 0;
+        digits = 0;
+        while (*p >= '0' && *p <= '9' && digits < 3) {
+            val = val * 10 + (*p - '0');
+            digits++;
+            p++;
+        }
+        if (digits == 0 || val > 255)
+            return FALSE;
+        ip[i] = (UBYTE)val;
+    }
+
+    *s = p;
+    return TRUE;
+}
+
+/* Helper: format a dotted-quad address into buf (16 bytes) */
+static void format_addr(ULONG ip_addr, char *buf)
+{
+    UBYTE *ip = (UBYTE *)&ip_addr;
+    int i, val, pos = 0;
+
+    for (i = 0; i < 4; i++) {
+        val = ip[i];
+        if (val >= 100) { buf[pos++] = '0' + (val / 100); val %= 100; }
+        if (val >= 10 || ip[i] >= 100) { buf[pos++] = '0' + (val / 10); val %= 10; }
+        buf[pos++] = '0' + val;
+        if (i < 3) buf[pos++] = '.';
+    }
+    buf[pos] = '\0';
+}
+
+/* Helper: parse one "name addr addr ..." line into the cache */
+static void parse_line(const char *line, ULONG expires)
+{
+    char name[SERVER_NAME_MAX];
+    ULONG addrs[DNS_MAX_ADDRS];
+    ULONG count = 0;
+    LONG i;
+
+    for (i = 0; i < SERVER_NAME_MAX - 1 && line[i] != '\0' &&
+                line[i] != ' ' && line[i] != '\n'; i++)
+        name[i] = line[i];
+    name[i] = '\0';
+    line += i;
+
+    while (*line == ' ' && count < DNS_MAX_ADDRS) {
+        line++;
+        if (!parse_addr(&line, &addrs[count]))
+            break;
+        count++;
+    }
+
+    if (name[0] != '\0' && count > 0)
+        set_entry(claim_entry(name), name, addrs, count, expires);
+}
+
+/* Helper: save the known-good addresses to a single file path */
+static BOOL save_to_path(const char *path)
+{
+    BPTR fh;
+    char buf[16];
+    LONG i, j;
+
+    fh = Open(path, MODE_NEWFILE);
+    if (!fh)
+        return FALSE;
+
+    for (i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (cache[i].name[0] == '\0')
+            continue;
+
+        FPuts(fh, cache[i].name);
+        for (j = 0; j < cache[i].count; j++) {
+            if (cache[i].fails[j] >= DNS_MAX_FAILS)
+                continue;
+            format_addr(cache[i].addrs[j], buf);
+            FPuts(fh, " ");
+            FPuts(fh, buf);
+        }
+        FPuts(fh, "\n");
+    }
+
+    Close(fh);
+    return TRUE;
+}
+
+/* =========================================================================
+ * Public API
+ * ========================================================================= */
+
+/* dnscache_load: read ENV:SyncTime.dns. The clock may not be right yet
+ * at boot, so saved entries get a full DNS_TTL from now. */
+void dnscache_load(void)
+{
+    BPTR fh;
+    char line[256];
+    ULONG expires = now_secs() + (ULONG)config_get()->dns_ttl;
+
+    fh = Open(DNS_ENV_PATH, MODE_OLDFILE);
+    if (!fh)
+        return;
+
+    while (FGets(fh, line, sizeof(line))) {
+        parse_line(line, expires);
+    }
+
+    Close(fh);
+    dirty = FALSE;
+    arc_dirty = FALSE;
+}
+
+/* dnscache_save: write to ENV:, if anything changed */
+BOOL dnscache_save(void)
+{
+    if (!dirty)
+        return TRUE;
+
+    if (!save_to_path(DNS_ENV_PATH))
+        return FALSE;
+
+    dirty = FALSE;
+    return TRUE;
+}
+
+/* dnscache_flush: write to ENVARC:, if anything changed since the last
+ * time (state.c's batched writes and exit) */
+BOOL dnscache_flush(void)
+{
+    if (!arc_dirty)
+        return TRUE;
+
+    if (!save_to_path(DNS_ENVARC_PATH))
+        return FALSE;
+
+    arc_dirty = FALSE;
+    return TRUE;
+}
+
+/* dnscache_store: cache a fresh DNS answer for a name. The files are
+ * only rewritten if the known-good set changed, not on every refresh. */
+void dnscache_store(const char *name, const ULONG *addrs, ULONG count)
+{
+    DNSEntry *e;
+
+    if (count == 0)
+        return;
+
+    e = find_entry(name);
+    if (e == NULL || !same_addrs(e, addrs, count))
+        dirty = arc_dirty = TRUE;
+
+    set_entry(claim_entry(name), name, addrs, count,
+              now_secs() + (ULONG)config_get()->dns_ttl);
+}
+
+/*
+ * dnscache_lookup - Next address to use for a name
+ *
+ * Rotates through the cached addresses, skipping demoted ones. Unless
+ * allow_stale is set (DNS just failed), expired entries count as
+ * missing. Returns FALSE if the name has to be resolved.
+ */
+BOOL dnscache_lookup(const char *name, BOOL allow_stale, ULONG *ip_addr)
+{
+    DNSEntry *e = find_entry(name);
+    UBYTE i, slot;
+
+    if (e == NULL || e->count == 0)
+        return FALSE;
+    if (!allow_stale && now_secs() >= e->expires)
+        return FALSE;
+
+    for (i = 0; i < e->count; i++) {
+        slot = e->next;
+        e->next = (UBYTE)((e->next + 1) % e->count);
+        if (e->fails[slot] < DNS_MAX_FAILS || allow_stale) {
+            *ip_addr = e->addrs[slot];
+            return TRUE;
+        }
+    }
+
+    /* Every address demoted: time to ask DNS again */
+    return FALSE;
+}
+
+/* dnscache_prefer: make ip_addr the next address handed out for name */
+void dnscache_prefer(const char *name, ULONG ip_addr)
+{
+    DNSEntry *e = find_entry(name);
+    UBYTE i;
+
+    if (e == NULL)
+        return;
+
+    for (i = 0; i < e->count; i++) {
+        if (e->addrs[i] == ip_addr) {
+            e->next = i;
+            return;
+        }
+    }
+}
+
+/* dnscache_report: record whether an address answered this sync */
+void dnscache_report(const char *name, ULONG ip_addr, BOOL answered)
+{
+    DNSEntry *e = find_entry(name);
+    UBYTE i;
+
+    if (e == NULL)
+        return;
+
+    for (i = 0; i < e->count; i++) {
+        if (e->addrs[i] != ip_addr)
+            continue;
+
+        if (answered) {
+            if (e->fails[i] >= DNS_MAX_FAILS)
+                dirty = arc_dirty = TRUE;  /* Back in the saved set */
+            e->fails[i] = 0;
+        } else if (e->fails[i] < DNS_MAX_FAILS) {
+            e->fails[i]++;
+            if (e->fails[i] == DNS_MAX_FAILS)
+                dirty = arc_dirty = TRUE;  /* Drops out of the saved set */
+        }
+        return;
+    }
+}
@@ -0,0 +1,270 @@
+/* filter.c - NTP clock filter for SyncTime
+ *
+ * Keeps a short register of (offset, delay) samples for one server
+ * and picks the sample with the lowest round-trip delay, as the NTP
+ * clock filter does (RFC 5905 section 10): the fastest exchange is
+ * the one least distorted by queueing, so its offset is the most
+ * trustworthy. Also reports the jitter of the register around the
+ * chosen offset.
+ *
+ * Pure data transformation, like sntp.c: no I/O.
+ */
+
+#include "synctime.h"
+
+/* --------------------------------------------------------------------------
+ * filter_reset - Empty the sample register
+ * -------------------------------------------------------------------------- */
+
+void filter_reset(ClockFilter *f)
+{
+    f->count = 0;
+    f->next = 0;
+}
+
+/* --------------------------------------------------------------------------
+ * filter_add - Shift a new sample into the register
+ *
+ * Once FILTER_STAGES samples are held, the oldest is overwritten.
+ * -------------------------------------------------------------------------- */
+
+void filter_add(ClockFilter *f, const SNTPResult *res)
+{
+    f->samples[f->next] = *res;
+    f->next++;
+    if (f->next >= FILTER_STAGES)
+        f->next = 0;
+    if (f->count < FILTER_STAGES)
+        f->count++;
+}
+
+/* --------------------------------------------------------------------------
+ * filter_select - Pick the minimum-delay sample from the register
+ *
+ * Copies the chosen sample to *best and, if jitter is non-NULL, the
+ * mean absolute difference between the other samples' offsets and
+ * the chosen one, in microseconds (the RMS of RFC 5905 would need a
+ * square root; the mean is good enough to steer polling).
+ *
+ * Returns FALSE if the register is empty.
+ * -------------------------------------------------------------------------- */
+
+BOOL filter_select(const ClockFilter *f, SNTPResult *best, ULONG *jitter)
+{
+    const SNTPResult *min;
+    NTPTime diff;
+    ULONG sum;
+    LONG us;
+    UBYTE i;
+
+    if (f->count == 0)
+        return FALSE;
+
+    /* Lowest delay wins; compare as 32.32 without conversion */
+    min = &f->samples[0];
+    for (i = 1; i < f->count; i++) {
+        const SNTPResult *s = &f->samples[i];
+        if (s->delay.secs < min->delay.secs ||
+            (s->delay.secs == min->delay.secs &&
+             s->delay.frac < min->delay.frac))
+            min = s;
+    }
+
+    *best = *min;
+
+    if (jitter) {
+        sum = 0;
+        for (i = 0; i < f->count; i++) {
+            ntp_sub(&diff, &f->samples[i].offset, &min->offset);
+            us = ntp_to_micro(&diff);
+            if (us < 0)
+                us = -us;
+            if (us > 0x0FFFFFFFL)
+                us = 0x0FFFFFFFL;  /* keep the sum of 8 in range */
+            sum += (ULONG)us;
+        }
+        *jitter = (f->count > 1) ? sum / (f->count - 1) : 0;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------
+ * Source selection and combining
+ *
+ * Each server's chosen sample defines a correctness interval
+ * [offset - r, offset + r], with r = delay / 2 + jitter (never below
+ * the resolution we can read our own clock with). The true offset
+ * must lie in the intersection of the truechimers' intervals, so
+ * a Marzullo-style sweep (RFC 5905 section 11.2.1) finds the smallest
+ * interval shared by a majority and discards the falsetickers whose
+ * intervals miss it. Survivors are averaged, weighted by 1 / r.
+ * -------------------------------------------------------------------------- */
+
+/* Local clock read resolution: E-clock timestamps are good to a few
+ * microseconds, but the stack's own scheduling still adds some */
+#define MIN_DISTANCE       1000UL
+
+/* Endpoint of a correctness interval for the sweep */
+typedef struct {
+    NTPTime val;
+    BYTE    type;              /* -1 lower, 0 midpoint, +1 upper */
+} Endpoint;
+
+/* Helper: signed compare of two NTP times */
+static LONG ntp_cmp(const NTPTime *a, const NTPTime *b)
+{
+    if (a->secs != b->secs)
+        return (a->secs < b->secs) ? -1 : 1;
+    if (a->frac != b->frac)
+        return (a->frac < b->frac) ? -1 : 1;
+    return 0;
+}
+
+/* Helper: root distance (interval half-width) of a candidate, microseconds */
+static ULONG distance_of(const SNTPResult *res, ULONG jitter)
+{
+    ULONG r = (ULONG)ntp_to_micro(&res->delay) / 2 + jitter;
+
+    return (r < MIN_DISTANCE) ? MIN_DISTANCE : r;
+}
+
+/*
+ * filter_combine - Select truechimers among servers and combine them
+ *
+ * cand[] and jitter[] hold the filter output of n servers (n at most
+ * MAX_SERVERS). On success, *out gets the combined offset and the
+ * lowest survivor delay, survivors (if non-NULL) a bit mask of the
+ * servers that were kept, and TRUE is returned. Returns FALSE if no
+ * majority of the servers agree.
+ */
+BOOL filter_combine(const SNTPResult *cand, const ULONG *jitter, UBYTE n,
+                    SNTPResult *out, ULONG *survivors)
+{
+    Endpoint ep[MAX_SERVERS * 3];
+    Endpoint tmp;
+    NTPTime r, low, high, diff;
+    ULONG dist[MAX_SERVERS];
+    ULONG kept;
+    LONG c, found, f, d;
+    LONG sum, wsum, w, us;
+    UBYTE i, j, k, best;
+
+    if (n == 0 || n > MAX_SERVERS)
+        return FALSE;
+
+    low.secs = high.secs = 0;
+    low.frac = high.frac = 0;
+
+    /* Build and sort the 3n endpoints (insertion sort, n is tiny) */
+    k = 0;
+    for (i = 0; i < n; i++) {
+        dist[i] = distance_of(&cand[i], jitter[i]);
+        ntp_from_micro(&r, (LONG)dist[i]);
+
+        ntp_sub(&ep[k].val, &cand[i].offset, &r);
+        ep[k++].type = -1;
+        ep[k].val = cand[i].offset;
+        ep[k++].type = 0;
+        ntp_add(&ep[k].val, &cand[i].offset, &r);
+        ep[k++].type = 1;
+    }
+    for (i = 1; i < k; i++) {
+        tmp = ep[i];
+        for (j = i; j > 0 && ntp_cmp(&ep[j - 1].val, &tmp.val) > 0; j--)
+            ep[j] = ep[j - 1];
+        ep[j] = tmp;
+    }
+
+    /* Allow f falsetickers, f < n / 2, until an intersection is found */
+    found = FALSE;
+    for (f = 0; f * 2 < n && !found; f++) {
+        d = 0;
+
+        c = 0;
+        for (i = 0; i < k; i++) {
+            c -= ep[i].type;
+            if (c >= n - f) {
+                low = ep[i].val;
+                break;
+            }
+            if (ep[i].type == 0)
+                d++;
+        }
+
+        c = 0;
+        for (i = k; i > 0; i--) {
+            c += ep[i - 1].type;
+            if (c >= n - f) {
+                high = ep[i - 1].val;
+                break;
+            }
+            if (ep[i - 1].type == 0)
+                d++;
+        }
+
+        if (d <= f && ntp_cmp(&low, &high) < 0)
+            found = TRUE;
+    }
+
+    if (!found)
+        return FALSE;
+
+    /* Survivors: intervals that overlap [low, high]; remember the one
+     * with the smallest distance as the reference */
+    kept = 0;
+    best = 0xFF;
+    for (i = 0; i < n; i++) {
+        NTPTime lo, hi;
+
+        ntp_from_micro(&r, (LONG)dist[i]);
+        ntp_sub(&lo, &cand[i].offset, &r);
+        ntp_add(&hi, &cand[i].offset, &r);
+        if (ntp_cmp(&lo, &high) > 0 || ntp_cmp(&hi, &low) < 0)
+            continue;
+
+        kept |= 1UL << i;
+        if (best == 0xFF || dist[i] < dist[best])
+            best = i;
+    }
+
+    if (best == 0xFF)
+        return FALSE;
+
+    *out = cand[best];
+
+    /* Weighted mean of the survivors relative to the best one. Weights
+     * are 1..256 and deviations are capped at +/-1s, so the sums stay
+     * within 32 bits; a survivor further from the best one than that is
+     * left out of the mean. */
+    sum = 0;
+    wsum = 0;
+    for (i = 0; i < n; i++) {
+        if (!(kept & (1UL << i)))
+            continue;
+
+        ntp_sub(&diff, &cand[i].offset, &cand[best].offset);
+        us = ntp_to_micro(&diff);
+        if (us > 1000000L || us < -1000000L)
+            continue;
+
+        w = 256L / (LONG)(dist[i] / MIN_DISTANCE);
+        if (w < 1)
+            w = 1;
+        sum += w * us;
+        wsum += w;
+
+        if (ntp_cmp(&cand[i].delay, &out->delay) < 0)
+            out->delay = cand[i].delay;
+    }
+
+    if (wsum > 0) {
+        ntp_from_micro(&diff, sum / wsum);
+        ntp_add(&out->offset, &cand[best].offset, &diff);
+    }
+
+    if (survivors)
+        *survivors = kept;
+
+    return TRUE;
+}
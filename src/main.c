@@ -1,7 +1,7 @@
 /* main.c - SyncTime entry point and commodity event loop
  *
- * Ties together all modules: config, network, sntp, clock, window.
- * Implements the commodity broker, hotkey handling, periodic sync,
+ * Ties together all modules: config, network, resolver, sntp, clock,
+ * window. Implements the commodity broker, hotkey handling, periodic sync,
  * and the main event loop.
  */
 
@@ -39,6 +39,7 @@ struct Library       *CxBase        = NULL;
 struct Library       *UtilityBase   = NULL;
 struct Library       *SocketBase    = NULL;
 struct Device        *TimerBase     = NULL;
+APTR                  BattClockBase = NULL;
 
 /* Reaction class library bases */
 struct Library       *WindowBase      = NULL;
@@ -60,6 +61,54 @@ static BOOL cx_enabled  = TRUE;
 static SyncStatus sync_status;
 static BOOL first_sync_done = FALSE;  /* Track if we've ever synced successfully */
 
+/* Per-server state for one sync */
+typedef struct {
+    char        name[SERVER_NAME_MAX];
+    ULONG       ip_addr;
+    NTPTime     t1;            /* Transmit stamp the reply must echo */
+    ClockStamp  sent;          /* When the request actually left: T1 */
+    ClockFilter filter;        /* Sample register */
+} ServerState;
+
+static ServerState servers[MAX_SERVERS];
+
+/* Window for collecting the replies of one round */
+#define REPLY_TIMEOUT_MS 5000
+
+/* Longest we wait for the resolver process before giving up on names */
+#define RESOLVE_TIMEOUT_MS 15000
+
+/* Sync state machine phases */
+#define SYNC_IDLE      0
+#define SYNC_RESOLVE   1   /* Resolving server names */
+#define SYNC_SEND      2   /* Sending one round of requests */
+#define SYNC_AWAIT     3   /* Collecting replies within the timeout window */
+#define SYNC_SPACING   4   /* Pausing between burst rounds */
+#define SYNC_APPLY     5   /* Selecting, combining and setting the clock */
+
+/* Sync state machine context */
+static struct {
+    int            phase;
+    const TZEntry *tz;
+    char           names[MAX_SERVERS][SERVER_NAME_MAX];
+    ULONG          name_count;
+    ULONG          next_name;      /* SYNC_RESOLVE: next name to look up */
+    ULONG          resolving;      /* SYNC_RESOLVE: names the resolver owes us */
+    ULONG          count;          /* Servers that resolved (slots 0..count-1) */
+    LONG           round;          /* Current burst round */
+    ULONG          pending;        /* SYNC_AWAIT: slots still to answer */
+    ULONG          start_secs;     /* Start of the current wait */
+    ULONG          start_micro;
+    ULONG          wait_ms;        /* Length of the current wait */
+    ULONG          samples;        /* Good replies this sync */
+    ClockStamp     last_rx;        /* Receipt of the newest good reply */
+    const char    *err;            /* Status text of the last failure */
+    BOOL           quiet;          /* Startup retry: errors not logged */
+} sync;
+
+/* Signal bit used to kick the state machine into its next step */
+static BYTE sync_sigbit = -1;
+
 /* Custom event ID for hotkey */
 #define EVT_HOTKEY 1
 
@@ -71,7 +120,8 @@ static BOOL open_libraries(void);
 static void close_libraries(void);
 static BOOL setup_commodity(int argc, char **argv);
 static void cleanup_commodity(void);
-static void perform_sync(void);
+static BOOL sync_start(BOOL quiet);
+static void dst_plan(const TZEntry *tz, ULONG utc_secs, ULONG utc_micro);
 static void event_loop(void);
 
 /* =========================================================================
@@ -135,7 +185,7 @@ static BOOL open_libraries(void)
         return FALSE;
 
     /* bsdsocket.library is opened by network_init() */
-    /* timer.device is opened by clock_init() */
+    /* timer.device and battclock.resource are opened by clock_init() */
 
     return TRUE;
 }
@@ -288,14 +338,16 @@ static void cleanup_commodity(void)
 }
 
 /* =========================================================================
- * perform_sync - Execute a single NTP synchronization
+ * Sync state machine
  *
- * Logs each step to the scrollable log and updates status on completion.
+ * A sync runs as a series of short steps driven from event_loop():
+ * resolve -> (send -> await -> spacing) x burst -> apply. Each step
+ * does a bounded amount of work and returns, so the GUI, Exchange
+ * commands and hotkey stay responsive. Socket readiness and phase
+ * timeouts are folded into the loop's wait through WaitSelect()'s
+ * signal mask; steps that can continue at once kick sync_sigbit.
  * ========================================================================= */
 
-/* Re-entrancy guard */
-static BOOL sync_in_progress = FALSE;
-
 /* Helper to update main status field */
 static void set_status(int status_code, const char *text)
 {
@@ -312,6 +364,22 @@ static void set_status(int status_code, const char *text)
         window_update_status(&sync_status);
 }
 
+/* Helper to format the last/next sync times (UTC) as local time, at
+ * the offset the clock carries now */
+static void refresh_status_times(void)
+{
+    if (sync_status.last_sync_secs != 0)
+        clock_format_time(clock_utc_to_local(sync_status.last_sync_secs),
+                          sync_status.last_sync_text,
+                          sizeof(sync_status.last_sync_text));
+    if (sync_status.next_sync_secs != 0)
+        clock_format_time(clock_utc_to_local(sync_status.next_sync_secs),
+                          sync_status.next_sync_text,
+                          sizeof(sync_status.next_sync_text));
+    if (window_is_open())
+        window_update_status(&sync_status);
+}
+
 /* Helper to format IP address into buffer */
 static void format_ip(ULONG ip_addr, char *buf)
 {
@@ -328,148 +396,782 @@ static void format_ip(ULONG ip_addr, char *buf)
     buf[pos] = '\0';
 }
 
-static void perform_sync(void)
+/* Helper to append an unsigned decimal number, zero-padded to min_digits */
+static char *append_num(char *p, ULONG val, int min_digits)
+{
+    char tmp[12];
+    int i = 0;
+
+    do {
+        tmp[i++] = '0' + (char)(val % 10);
+        val /= 10;
+    } while (val > 0 || i < min_digits);
+
+    while (i > 0)
+        *p++ = tmp[--i];
+
+    return p;
+}
+
+/* Helper to log the measured offset and round-trip delay, e.g.
+ * "Offset -0.012345s, delay 42ms" */
+static void log_offset(const SNTPResult *res)
+{
+    char msg[64];
+    char *p;
+    LONG secs = res->offset.secs;
+    ULONG micro = ntp_frac_to_micro(res->offset.frac);
+
+    /* Offset is floor seconds + positive micro; show it as sign + magnitude */
+    strcpy(msg, "Offset ");
+    p = msg + 7;
+    if (secs < 0) {
+        *p++ = '-';
+        if (micro > 0) {
+            secs++;
+            micro = 1000000 - micro;
+        }
+        secs = -secs;
+    } else {
+        *p++ = '+';
+    }
+    p = append_num(p, (ULONG)secs, 1);
+    *p++ = '.';
+    p = append_num(p, micro, 6);
+    strcpy(p, "s, delay ");
+    p += 9;
+    p = append_num(p, (ULONG)ntp_to_micro(&res->delay) / 1000, 1);
+    strcpy(p, "ms");
+
+    window_log(msg);
+}
+
+/* Helper to convert a local clock reading to an NTP timestamp, at
+ * the zone offset the clock carries */
+static void stamp_to_ntp(const ClockStamp *c, NTPTime *t)
+{
+    t->secs = (LONG)((ULONG)((LONG)c->secs - clock_utc_offset()) +
+                     NTP_TO_AMIGA_EPOCH);
+    t->frac = ntp_micro_to_frac(c->micro);
+}
+
+/* Helper to read the clock as an NTP timestamp */
+static void get_ntp_time(NTPTime *t)
+{
+    ClockStamp now;
+
+    clock_get_precise_time(&now);
+    stamp_to_ntp(&now, t);
+}
+
+/* Helper: log a line of a sync's progress, unless it is a startup
+ * retry whose failure netready.c has already reported */
+static void sync_log(const char *msg)
+{
+    if (!sync.quiet)
+        window_log(msg);
+}
+
+/* Helper to log "<prefix><server name>" truncated to fit the log line
+ * (prefixes are short literals; the name gets what is left of msg) */
+static void log_server(const char *prefix, const char *name)
+{
+    char msg[64];
+    int i, len = strlen(prefix);
+
+    strcpy(msg, prefix);
+    for (i = 0; i < 40 && i < (int)sizeof(msg) - len - 1 && name[i]; i++)
+        msg[len + i] = name[i];
+    msg[len + i] = '\0';
+    sync_log(msg);
+}
+
+/* Helper to return milliseconds elapsed since start_secs/start_micro */
+static ULONG elapsed_ms(ULONG start_secs, ULONG start_micro)
+{
+    ULONG secs, micro;
+
+    clock_get_utc(&secs, &micro);
+    if (secs < start_secs)
+        return 0;
+    return (secs - start_secs) * 1000 + micro / 1000 - start_micro / 1000;
+}
+
+/*
+ * send_request - Send one request to a server
+ *
+ * The packet carries the time it was built; network.c takes the real
+ * T1 right before the send call, so the socket work in between does
+ * not count as network delay.
+ *
+ * Returns TRUE if the request went out.
+ */
+static BOOL send_request(ULONG slot)
 {
-    SyncConfig *cfg;
-    const TZEntry *tz;
-    ULONG ip_addr;
     UBYTE packet[NTP_PACKET_SIZE];
-    ULONG ntp_secs;
-    ULONG ntp_frac;
+    ServerState *srv = &servers[slot];
+
+    get_ntp_time(&srv->t1);
+    sntp_build_request(packet, &srv->t1);
+    return network_send_udp(slot, srv->ip_addr, NTP_PORT,
+                            packet, NTP_PACKET_SIZE, &srv->sent);
+}
+
+/*
+ * read_reply - Receive a ready reply on a slot, T4 on receipt
+ *
+ * No logging here: several replies may be waiting and each one's T4
+ * must be taken as early as possible. On failure sets *err to a
+ * short status text and returns FALSE.
+ */
+static BOOL read_reply(ULONG slot, SNTPResult *res, ClockStamp *received,
+                       const char **err)
+{
+    UBYTE packet[NTP_PACKET_SIZE];
+    SNTPTimestamps ts;
     LONG bytes;
-    ULONG amiga_secs;
+
+    bytes = network_recv_udp(slot, packet, NTP_PACKET_SIZE, received);
+    if (bytes < NTP_PACKET_SIZE) {
+        *err = "Bad response";
+        return FALSE;
+    }
+    stamp_to_ntp(received, &ts.t4);
+
+    /* Parse SNTP response (T2, T3) against the stamp we sent, then
+     * compute offset/delay from when the request really left */
+    ts.t1 = servers[slot].t1;
+    if (!sntp_parse_response(packet, &ts)) {
+        *err = "Invalid response";
+        return FALSE;
+    }
+    stamp_to_ntp(&servers[slot].sent, &ts.t1);
+    if (!sntp_compute_offset(&ts, res)) {
+        *err = "Bad response";
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Helper: ask event_loop() to run the next step without waiting */
+static void sync_kick(void)
+{
+    Signal(FindTask(NULL), 1UL << sync_sigbit);
+}
+
+/* Helper: end the sync with an error. Sockets stay open for the next
+ * sync; those that failed have already been closed. Once synced, the
+ * discipline keeps the clock running in holdover; say how well. */
+static void sync_fail(const char *text)
+{
     char msg[64];
+    char *p;
 
-    /* Prevent re-entrancy */
-    if (sync_in_progress) {
-        window_log("Sync already in progress, skipping");
-        return;
+    if (first_sync_done) {
+        strcpy(msg, "Holdover, estimated error +/-");
+        p = append_num(msg + 29, discipline_error_bound() / 1000, 1);
+        strcpy(p, "ms");
+        window_log(msg);
     }
-    sync_in_progress = TRUE;
 
-    /* Get current configuration */
-    cfg = config_get();
+    set_status(STATUS_ERROR, text);
+    sync.phase = SYNC_IDLE;
+}
+
+/*
+ * sync_start - Begin a sync if none is running
+ *
+ * A quiet sync (startup retry) logs only its success.
+ *
+ * Returns TRUE if a sync was started.
+ */
+static BOOL sync_start(BOOL quiet)
+{
+    SyncConfig *cfg = config_get();
+
+    if (sync.phase != SYNC_IDLE) {
+        window_log("Sync already in progress, skipping");
+        return FALSE;
+    }
 
     /* Look up timezone entry */
-    tz = tz_find_by_name(cfg->tz_name);
-    if (tz == NULL) {
-        window_log("WARNING: Unknown timezone, using UTC");
+    sync.tz = tz_find_by_name(cfg->tz_name);
+    if (sync.tz == NULL) {
+        if (!quiet)
+            window_log("WARNING: Unknown timezone, using UTC");
         /* Fall through with NULL tz - tz_get_offset_mins handles NULL */
     }
 
-    /* Step 1: Resolve server hostname */
+    sync.name_count = config_get_servers(sync.names, MAX_SERVERS);
+    sync.next_name = 0;
+    sync.resolving = 0;
+    sync.pending = 0;
+    sync.count = 0;
+    network_socket_ops(TRUE);
+    sync.round = 0;
+    sync.samples = 0;
+    sync.err = "Timeout";
+    sync.quiet = quiet;
+    sync.phase = SYNC_RESOLVE;
+
     set_status(STATUS_SYNCING, "Syncing...");
-    strcpy(msg, "Resolving ");
-    {
-        int i;
-        for (i = 0; i < 40 && cfg->server[i]; i++)
-            msg[10 + i] = cfg->server[i];
-        msg[10 + i] = '\0';
-    }
-    window_log(msg);
+    sync_kick();
+    return TRUE;
+}
+
+/* sync_abort - Drop a running sync (commodity disabled, clock jumped) */
+static void sync_abort(void)
+{
+    ULONG i;
 
-    if (!network_resolve(cfg->server, &ip_addr)) {
-        window_log("ERROR: DNS lookup failed");
-        set_status(STATUS_ERROR, "DNS failed");
-        sync_in_progress = FALSE;
+    if (sync.phase == SYNC_IDLE)
         return;
+
+    if (sync.resolving != 0)
+        resolver_cancel();
+    for (i = 0; i < MAX_SERVERS; i++)
+        network_close_udp(i);
+    sync.phase = SYNC_IDLE;
+}
+
+/*
+ * sync_wait_ms - Milliseconds until the current phase times out
+ *
+ * Returns 0 if the phase is not waiting on anything timed.
+ */
+static ULONG sync_wait_ms(void)
+{
+    ULONG waited;
+
+    if (sync.phase != SYNC_AWAIT && sync.phase != SYNC_SPACING &&
+        !(sync.phase == SYNC_RESOLVE && sync.resolving != 0))
+        return 0;
+
+    waited = elapsed_ms(sync.start_secs, sync.start_micro);
+    if (waited >= sync.wait_ms)
+        return 1;  /* Expired: poll once more, then step */
+    return sync.wait_ms - waited;
+}
+
+/* Helper: take a name's address into the next server slot */
+static void add_server(const char *name, ULONG ip_addr, const char *how)
+{
+    char msg[64];
+    ServerState *srv = &servers[sync.count++];
+    int len = strlen(how);
+
+    strcpy(srv->name, name);
+    srv->ip_addr = ip_addr;
+    filter_reset(&srv->filter);
+
+    /* Log the address used */
+    strcpy(msg, how);
+    format_ip(ip_addr, msg + len);
+    sync_log(msg);
+}
+
+/* Helper: cache a DNS answer (count 0 = lookup failed) and use the next
+ * address, falling back to an expired entry if DNS came up empty */
+static void take_answer(const char *name, const ULONG *addrs, ULONG count)
+{
+    ULONG ip_addr;
+
+    dnscache_store(name, addrs, count);
+    if (dnscache_lookup(name, TRUE, &ip_addr))
+        add_server(name, ip_addr, count > 0 ? "Resolved to " : "Using cached ");
+}
+
+/* Helper: fill the slots the names left free with more of their cached
+ * addresses. A pool name stands for many servers, so a single
+ * pool.ntp.org still gives filter_combine() several candidates to
+ * outvote a bad one with. */
+static void fill_servers(void)
+{
+    ULONG named = sync.count;
+    ULONG ip_addr, i, j, tries;
+    BOOL added = TRUE;
+
+    while (added && sync.count < MAX_SERVERS) {
+        added = FALSE;
+        for (i = 0; i < named && sync.count < MAX_SERVERS; i++) {
+            for (tries = 0; tries < DNS_MAX_ADDRS; tries++) {
+                if (!dnscache_lookup(servers[i].name, FALSE, &ip_addr))
+                    break;
+                for (j = 0; j < sync.count; j++) {
+                    if (servers[j].ip_addr == ip_addr)
+                        break;
+                }
+                if (j == sync.count) {
+                    add_server(servers[i].name, ip_addr, "Also using ");
+                    added = TRUE;
+                    break;
+                }
+            }
+        }
     }
+}
 
-    /* Log resolved IP */
-    strcpy(msg, "Resolved to ");
-    format_ip(ip_addr, msg + 12);
-    window_log(msg);
+/*
+ * Step: resolve the server names
+ *
+ * Names with a fresh DNS cache entry are used straight away. With the
+ * resolver process running, the others are queued at once and the
+ * replies collected as its port signals, within RESOLVE_TIMEOUT_MS.
+ * Without it, fall back to one blocking network_resolve() per
+ * dispatch.
+ */
+static void step_resolve(void)
+{
+    ULONG addrs[DNS_MAX_ADDRS];
+    const char *name;
+    ULONG id, count, ip_addr, i;
+
+    if (!resolver_available()) {
+        if (sync.next_name < sync.name_count) {
+            name = sync.names[sync.next_name++];
+            if (dnscache_lookup(name, FALSE, &ip_addr)) {
+                add_server(name, ip_addr, "Cached ");
+            } else {
+                log_server("Resolving ", name);
+                count = network_resolve(name, addrs, DNS_MAX_ADDRS);
+                if (count == 0)
+                    log_server("ERROR: DNS lookup failed for ", name);
+                take_answer(name, addrs, count);
+            }
+            sync_kick();
+            return;
+        }
+    } else {
+        /* First dispatch: hand every uncached name to the resolver */
+        if (sync.next_name < sync.name_count) {
+            for (i = 0; i < sync.name_count; i++) {
+                name = sync.names[i];
+                if (dnscache_lookup(name, FALSE, &ip_addr)) {
+                    add_server(name, ip_addr, "Cached ");
+                    continue;
+                }
+                log_server("Resolving ", name);
+                if (resolver_request(i, name)) {
+                    sync.resolving |= 1UL << i;
+                } else {
+                    log_server("ERROR: DNS lookup failed for ", name);
+                    take_answer(name, addrs, 0);
+                }
+            }
+            sync.next_name = sync.name_count;
+            clock_get_utc(&sync.start_secs, &sync.start_micro);
+            sync.wait_ms = RESOLVE_TIMEOUT_MS;
+        }
 
-    /* Step 2: Build and send SNTP request packet */
-    window_log("Sending NTP request to port 123...");
-    sntp_build_request(packet);
-    if (!network_send_udp(ip_addr, NTP_PORT, packet, NTP_PACKET_SIZE)) {
-        window_log("ERROR: Failed to send UDP packet");
-        set_status(STATUS_ERROR, "Send failed");
-        sync_in_progress = FALSE;
-        return;
+        while (resolver_get_reply(&id, addrs, &count)) {
+            if (id >= sync.name_count || !(sync.resolving & (1UL << id)))
+                continue;
+            sync.resolving &= ~(1UL << id);
+            if (count == 0)
+                log_server("ERROR: DNS lookup failed for ", sync.names[id]);
+            take_answer(sync.names[id], addrs, count);
+        }
+
+        if (sync.resolving != 0) {
+            if (elapsed_ms(sync.start_secs, sync.start_micro) < sync.wait_ms)
+                return;
+
+            /* Out of time: abandon the lookups still running */
+            resolver_cancel();
+            for (i = 0; i < sync.name_count; i++) {
+                if (sync.resolving & (1UL << i)) {
+                    log_server("ERROR: DNS timeout for ", sync.names[i]);
+                    take_answer(sync.names[i], addrs, 0);
+                }
+            }
+            sync.resolving = 0;
+        }
     }
-    window_log("Request sent, waiting for response...");
 
-    /* Step 3: Wait for response (5 second timeout) */
-    bytes = network_recv_udp(packet, NTP_PACKET_SIZE, 5);
-    if (bytes < 0) {
-        window_log("ERROR: Timeout waiting for response");
-        set_status(STATUS_ERROR, "Timeout");
-        sync_in_progress = FALSE;
+    if (sync.count == 0) {
+        sync_fail("DNS failed");
         return;
     }
-    if (bytes < NTP_PACKET_SIZE) {
-        window_log("ERROR: Response too short");
-        set_status(STATUS_ERROR, "Bad response");
-        sync_in_progress = FALSE;
+
+    fill_servers();
+    sync.phase = SYNC_SEND;
+    sync_kick();
+}
+
+/* Step: send one request to every server and start the reply window */
+static void step_send(void)
+{
+    ULONG i;
+
+    sync.pending = 0;
+    for (i = 0; i < sync.count; i++) {
+        if (send_request(i))
+            sync.pending |= 1UL << i;
+        else
+            sync.err = "Send failed";
+    }
+
+    clock_get_utc(&sync.start_secs, &sync.start_micro);
+    sync.wait_ms = REPLY_TIMEOUT_MS;
+    sync.phase = SYNC_AWAIT;
+
+    if (sync.pending == 0)
+        sync_kick();
+}
+
+/* Step: take the replies that are ready; end the round when all are
+ * in or the window has closed. A datagram that is not a usable answer
+ * (a late reply to an earlier round, a short or garbled packet) leaves
+ * its server pending, so the genuine reply behind it still counts. */
+static void step_await(ULONG ready)
+{
+    SNTPResult res;
+    ClockStamp received;
+    SyncConfig *cfg = config_get();
+    ULONG i;
+
+    for (i = 0; i < sync.count; i++) {
+        if (!(ready & sync.pending & (1UL << i)))
+            continue;
+        if (read_reply(i, &res, &received, &sync.err)) {
+            sync.pending &= ~(1UL << i);
+            filter_add(&servers[i].filter, &res);
+            sync.samples++;
+            sync.last_rx = received;
+        }
+    }
+
+    if (sync.pending != 0 &&
+        elapsed_ms(sync.start_secs, sync.start_micro) < sync.wait_ms)
         return;
+
+    /* Round over: rebuild the sockets of servers that never answered,
+     * in case the route or interface changed under them */
+    for (i = 0; i < sync.count; i++) {
+        if (sync.pending & (1UL << i)) {
+            network_close_udp(i);
+            sync.err = "Timeout";
+        }
     }
-    window_log("Received 48-byte response");
+    sync.pending = 0;
 
-    /* Step 4: Parse SNTP response */
-    window_log("Parsing NTP response...");
-    if (!sntp_parse_response(packet, &ntp_secs, &ntp_frac)) {
-        window_log("ERROR: Invalid NTP packet format");
-        set_status(STATUS_ERROR, "Invalid response");
-        sync_in_progress = FALSE;
+    sync.round++;
+    if (sync.round < cfg->burst) {
+        clock_get_utc(&sync.start_secs, &sync.start_micro);
+        sync.wait_ms = (ULONG)cfg->burst_spacing;
+        sync.phase = SYNC_SPACING;
+    } else {
+        sync.phase = SYNC_APPLY;
+        sync_kick();
+    }
+}
+
+/* Step: pause between burst rounds */
+static void step_spacing(void)
+{
+    if (elapsed_ms(sync.start_secs, sync.start_micro) < sync.wait_ms)
         return;
+
+    sync.phase = SYNC_SEND;
+    sync_kick();
+}
+
+/* Helper: tell the DNS cache which servers answered this sync and log
+ * the ones that did not. Disk and GUI work, so not before the clock
+ * is set. */
+static void report_replies(ULONG answered)
+{
+    ULONG i;
+
+    for (i = 0; i < sync.count; i++) {
+        if (answered & (1UL << i)) {
+            dnscache_report(servers[i].name, servers[i].ip_addr, TRUE);
+        } else {
+            dnscache_report(servers[i].name, servers[i].ip_addr, FALSE);
+            log_server("ERROR: No reply from ", servers[i].name);
+        }
     }
-    window_log("Response valid, extracting time...");
+    dnscache_save();
+}
 
-    /* Step 5: Convert NTP time to Amiga time */
-    amiga_secs = sntp_ntp_to_amiga(ntp_secs, tz);
+/* Step: select and combine the samples, then set the clock */
+static void step_apply(void)
+{
+    SyncConfig *cfg = config_get();
+    SNTPResult cand[MAX_SERVERS];
+    ULONG jitter[MAX_SERVERS];
+    UBYTE cand_slot[MAX_SERVERS];
+    SNTPResult res;
+    NTPTime now;
+    ULONG micro;
+    ULONG amiga_secs;
+    ULONG utc_secs;
+    LONG zone_offset;
+    ULONG survivors;
+    ULONG answered;
+    ULONG best_jitter;
+    ULONG best;
+    ULONG i;
+    LONG offset_us;
+    ULONG mag;
+    BOOL slewed;
+    UBYTE n;
+    char msg[64];
+    char *p;
+
+    /* Minimum-delay sample of each server that answered. Nothing but
+     * the clock set itself happens before the set: addresses are
+     * reported to the DNS cache (demoting the silent ones) and
+     * everything is logged afterwards. */
+    n = 0;
+    answered = 0;
+    for (i = 0; i < sync.count; i++) {
+        if (filter_select(&servers[i].filter, &cand[n], &jitter[n])) {
+            answered |= 1UL << i;
+            cand_slot[n] = (UBYTE)i;
+            n++;
+        }
+    }
 
-    /* Step 6: Set the system clock */
-    window_log("Setting system clock...");
-    if (!clock_set_system_time(amiga_secs, 0)) {
-        window_log("ERROR: Failed to set system time");
-        set_status(STATUS_ERROR, "Clock set failed");
-        sync_in_progress = FALSE;
+    if (n == 0) {
+        report_replies(answered);
+        sync_fail(sync.err);
         return;
     }
 
+    /* Intersect the candidates, drop falsetickers, combine */
+    if (!filter_combine(cand, jitter, n, &res, &survivors)) {
+        report_replies(answered);
+        sync_log("ERROR: Servers disagree, no majority");
+        sync_fail("No agreement");
+        return;
+    }
+
+    /* Corrected time at the newest receipt is its UTC reading + offset;
+     * convert to Amiga (local) time. A step adds the E-clock time
+     * elapsed since that receipt right before TR_SETSYSTIME. */
+    stamp_to_ntp(&sync.last_rx, &now);
+    ntp_add(&now, &now, &res.offset);
+    utc_secs = (ULONG)now.secs - NTP_TO_AMIGA_EPOCH;
+    amiga_secs = sntp_ntp_to_amiga((ULONG)now.secs, sync.tz);
+    micro = ntp_frac_to_micro(now.frac);
+    zone_offset = (LONG)(amiga_secs - utc_secs);
+
+    /* Slew small corrections, step large ones, or a clock that has to
+     * move to a new zone offset (time zone changed, DST change missed
+     * while not running). A new slew replaces one still running: this
+     * offset already includes what it had left. */
+    offset_us = ntp_to_micro(&res.offset);
+    mag = (offset_us < 0) ? (ULONG)-offset_us : (ULONG)offset_us;
+    slewed = (mag < (ULONG)cfg->step_threshold * 1000) &&
+             zone_offset == clock_utc_offset();
+    if (slewed) {
+        if (!clock_slew(offset_us, (ULONG)cfg->slew_rate)) {
+            report_replies(answered);
+            sync_log("ERROR: Failed to slew system time");
+            sync_fail("Clock set failed");
+            return;
+        }
+    } else {
+        clock_stop_slew();
+        if (!clock_set_time_at(amiga_secs, micro, &sync.last_rx)) {
+            report_replies(answered);
+            sync_log("ERROR: Failed to set system time");
+            sync_fail("Clock set failed");
+            return;
+        }
+        clock_set_utc_offset(zone_offset);
+    }
+
+    /* The UTC timeline restarts from the corrected time */
+    clock_anchor_utc(utc_secs, micro, &sync.last_rx.ec);
+
     /* Success! */
+    sync.quiet = FALSE;
+    report_replies(answered);
+    for (i = 0; i < n; i++) {
+        if (!(survivors & (1UL << i)))
+            log_server("Falseticker rejected: ", servers[cand_slot[i]].name);
+    }
+    strcpy(msg, "Samples: ");
+    p = append_num(msg + 9, sync.samples, 1);
+    strcpy(p, " from ");
+    p = append_num(p + 6, (ULONG)n, 1);
+    strcpy(p, " servers, ");
+    p = append_num(p + 10, network_socket_ops(FALSE), 1);
+    strcpy(p, " socket ops");
+    window_log(msg);
+    log_offset(&res);
+    if (slewed) {
+        strcpy(msg, "Slewing clock, done in about ");
+        p = append_num(msg + 29, mag / (ULONG)cfg->slew_rate + 1, 1);
+        strcpy(p, "s");
+        window_log(msg);
+    }
     window_log("Clock synchronized successfully!");
     first_sync_done = TRUE;
 
+    /* Judge this result for the next poll interval and the frequency
+     * estimate, using the jitter of the steadiest survivor */
+    best_jitter = 0xFFFFFFFFUL;
+    best = 0;
+    for (i = 0; i < n; i++) {
+        if ((survivors & (1UL << i)) && jitter[i] < best_jitter) {
+            best_jitter = jitter[i];
+            best = cand_slot[i];
+        }
+    }
+    poll_update(offset_us, best_jitter);
+    discipline_update(offset_us,
+                      (ULONG)ntp_to_micro(&res.delay) / 2 + best_jitter,
+                      utc_secs);
+    state_record(offset_us, servers[best].name, servers[best].ip_addr);
+
+    /* The clock now carries the right DST state; wake for the next
+     * change */
+    dst_plan(sync.tz, utc_secs, micro);
+
+    /* So the next boot starts from the right time too */
+    clock_battclock_update((ULONG)cfg->battclock);
+
     /* Update sync status with timestamps */
     sync_status.status = STATUS_OK;
     strcpy(sync_status.status_text, "Synchronized");
-    sync_status.last_sync_secs = amiga_secs;
-    clock_format_time(amiga_secs, sync_status.last_sync_text,
-                      sizeof(sync_status.last_sync_text));
-    sync_status.next_sync_secs = amiga_secs + cfg->interval;
-    clock_format_time(sync_status.next_sync_secs, sync_status.next_sync_text,
-                      sizeof(sync_status.next_sync_text));
-    if (window_is_open())
-        window_update_status(&sync_status);
+    sync_status.last_sync_secs = utc_secs;
+    sync_status.next_sync_secs = utc_secs + poll_interval();
+    refresh_status_times();
+
+    sync.phase = SYNC_IDLE;
+}
+
+/*
+ * sync_step - Run one step of the state machine
+ *
+ * ready is the mask of socket slots WaitSelect() reported readable.
+ * Returns TRUE when the sync has just finished (either way).
+ */
+static BOOL sync_step(ULONG ready)
+{
+    switch (sync.phase) {
+        case SYNC_RESOLVE: step_resolve();      break;
+        case SYNC_SEND:    step_send();         break;
+        case SYNC_AWAIT:   step_await(ready);   break;
+        case SYNC_SPACING: step_spacing();      break;
+        case SYNC_APPLY:   step_apply();        break;
+        default:           return FALSE;
+    }
+
+    return (sync.phase == SYNC_IDLE);
+}
+
+/* =========================================================================
+ * DST transitions
+ *
+ * The Amiga clock holds local time, so a DST change means moving it by
+ * dst_offset_mins. After each sync the timer queue is armed for the
+ * next transition of the zone (at most DST_MAX_WAIT ahead, then
+ * re-planned), and at that instant the clock is shifted and TZ/TZONE
+ * are set again, with no network traffic.
+ * ========================================================================= */
+
+/* Longest single wait for a transition, seconds */
+#define DST_MAX_WAIT 86400UL
+
+static const TZEntry *dst_tz = NULL;  /* Zone the clock was last set for */
+
+/* Timer queue callback (CLOCK_EV_DST): shift the clock across the
+ * transition, if it has been reached, and plan the next one */
+static void dst_due(void)
+{
+    ClockStamp now;
+    LONG offset_secs, shift_secs;
+    ULONG utc_secs;
+
+    if (dst_tz == NULL || !clock_get_precise_time(&now))
+        return;
+
+    /* UTC from the offset the clock is known to carry, so the hour
+     * around the transition is not ambiguous */
+    utc_secs = (ULONG)((LONG)now.secs - clock_utc_offset());
+
+    offset_secs = tz_get_offset_mins(dst_tz, utc_secs) * 60;
+    shift_secs = offset_secs - clock_utc_offset();
+    if (shift_secs != 0) {
+        if (!clock_set_time_at((ULONG)((LONG)now.secs + shift_secs),
+                               now.micro, &now)) {
+            window_log("ERROR: Failed to set system time");
+        } else {
+            clock_set_utc_offset(offset_secs);
+            tz_set_env(dst_tz);
+            refresh_status_times();
+            window_log((shift_secs > 0) ? "Daylight saving time started"
+                                        : "Daylight saving time ended");
+        }
+    }
 
-    sync_in_progress = FALSE;
+    dst_plan(dst_tz, utc_secs, now.micro);
+}
+
+/* dst_plan: note the zone the clock was just set for and arm the
+ * wakeup for its next transition after utc_secs */
+static void dst_plan(const TZEntry *tz, ULONG utc_secs, ULONG utc_micro)
+{
+    ULONG next, wait_ms;
+
+    dst_tz = tz;
+
+    if (!tz_next_transition(tz, utc_secs, &next)) {
+        clock_event_cancel(CLOCK_EV_DST);
+        return;
+    }
+
+    if (next - utc_secs > DST_MAX_WAIT)
+        wait_ms = DST_MAX_WAIT * 1000;
+    else
+        wait_ms = (next - utc_secs) * 1000 - utc_micro / 1000;
+    clock_event_in(CLOCK_EV_DST, wait_ms, dst_due);
 }
 
 /* =========================================================================
  * get_next_interval - Return timer interval based on sync history
  *
- * Before first successful sync: return STARTUP_RETRY_INTERVAL (1s) for rapid retry.
+ * Before first successful sync: return STARTUP_RETRY_INTERVAL (1s). That
+ * tick only probes the interface; netready.c decides whether a sync may
+ * go out, backing off NTP attempts while the servers do not answer.
  * After first success, if last sync failed: return RETRY_INTERVAL (30s).
- * After first success, if last sync succeeded: return configured interval.
+ * After first success, if last sync succeeded: return the adaptive poll interval.
  * ========================================================================= */
 
 static ULONG get_next_interval(void)
 {
-    /* Before first successful sync, retry every 1 second */
+    /* Before first successful sync, probe the network every second */
     if (!first_sync_done) {
         return STARTUP_RETRY_INTERVAL;
     }
 
-    /* After first success, use normal schedule or 30s retry on failure */
+    /* After first success, use adaptive schedule or 30s retry on failure */
     if (sync_status.status == STATUS_OK) {
-        return (ULONG)config_get()->interval;
+        return poll_interval();
     }
     return RETRY_INTERVAL;
 }
 
+/* Timer queue callback (CLOCK_EV_SYNC): start a sync; the timer is
+ * re-armed when it ends. Until the first success, only once the
+ * network looks ready, and quietly once a failure has been logged. */
+static void sync_due(void)
+{
+    ULONG delay_ms;
+
+    if (first_sync_done)
+        sync_start(FALSE);
+    else if (ready_check(&delay_ms))
+        sync_start(ready_quiet());
+    else
+        clock_event_in(CLOCK_EV_SYNC, delay_ms, sync_due);
+}
+
 /* =========================================================================
  * event_loop - Main commodity event loop
  * ========================================================================= */
@@ -477,30 +1179,58 @@ static ULONG get_next_interval(void)
 static void event_loop(void)
 {
     ULONG broker_sig = 1UL << broker_port->mp_SigBit;
-    ULONG timer_sig, win_sig;
+    ULONG sync_sig = 1UL << sync_sigbit;
+    ULONG res_sig = resolver_signal();
+    ULONG queue_sig = clock_queue_signal();
+    ULONG win_sig;
     ULONG signals;
+    ULONG wait_ms;
+    ULONG ready;
     CxMsg *cxmsg;
 
     while (running) {
-        timer_sig = clock_timer_signal();
         win_sig = window_signal();
-
-        signals = Wait(broker_sig | timer_sig | win_sig | SIGBREAKF_CTRL_C);
+        signals = broker_sig | queue_sig | win_sig | sync_sig | res_sig |
+                  SIGBREAKF_CTRL_C;
+        ready = 0;
+
+        /* While a sync waits for names, replies or a burst pause,
+         * WaitSelect() watches its sockets and timeout alongside our
+         * usual signals */
+        wait_ms = sync_wait_ms();
+        if (wait_ms > 0)
+            ready = network_wait_udp(sync.pending, wait_ms, &signals);
+        else
+            signals = Wait(signals);
 
         /* CTRL+C: exit */
         if (signals & SIGBREAKF_CTRL_C)
             break;
 
-        /* Timer fired: sync and restart timer */
-        if ((signals & timer_sig) && clock_check_timer()) {
-            /* Timer actually completed - acknowledged by clock_check_timer() */
-            perform_sync();
-            if (cx_enabled) {
+        /* Advance a running sync; re-arm the timer once it is done,
+         * counting from when this sync was due so it stays on schedule */
+        if ((signals & (sync_sig | res_sig)) || wait_ms > 0) {
+            if (sync_step(ready) && cx_enabled) {
+                ready_report(sync_status.status == STATUS_OK);
                 /* Use retry interval (30s) if sync failed, otherwise configured interval */
-                clock_start_timer(get_next_interval());
+                clock_event_next(CLOCK_EV_SYNC, get_next_interval() * 1000,
+                                 sync_due);
             }
         }
 
+        /* Clock jumped (emulator paused or restored, clock set by
+         * another program): resync now, the same way as "Sync Now" */
+        if (clock_check_jump() && cx_enabled && first_sync_done) {
+            window_log("Clock jumped, resyncing");
+            sync_abort();
+            clock_event_cancel(CLOCK_EV_SYNC);
+            sync_start(FALSE);
+        }
+
+        /* Timer queue: next sync, frequency correction, slew steps */
+        if (signals & queue_sig)
+            clock_run_events();
+
         /* Commodity messages */
         if (signals & broker_sig) {
             while ((cxmsg = (CxMsg *)GetMsg(broker_port)) != NULL) {
@@ -523,13 +1253,16 @@ static void event_loop(void)
                             case CXCMD_DISABLE:
                                 ActivateCxObj(broker, FALSE);
                                 cx_enabled = FALSE;
-                                clock_abort_timer();
+                                clock_event_cancel(CLOCK_EV_SYNC);
+                                clock_event_cancel(CLOCK_EV_DST);
+                                sync_abort();
+                                discipline_stop();
+                                clock_stop_slew();
                                 break;
                             case CXCMD_ENABLE:
                                 ActivateCxObj(broker, TRUE);
                                 cx_enabled = TRUE;
-                                perform_sync();
-                                clock_start_timer(get_next_interval());
+                                sync_start(FALSE);
                                 break;
                             case CXCMD_KILL:
                                 running = FALSE;
@@ -562,14 +1295,16 @@ static void event_loop(void)
 
             /* Handle "Sync Now" button */
             if (sync_now && cx_enabled) {
-                clock_abort_timer();
-                perform_sync();
-                clock_start_timer(get_next_interval());
+                clock_event_cancel(CLOCK_EV_SYNC);
+                sync_start(FALSE);
             }
-            /* If interval changed, restart timer */
-            else if (cfg->interval != old_interval && cx_enabled) {
-                clock_abort_timer();
-                clock_start_timer(get_next_interval());
+            /* If interval changed, adapt from there and restart the
+             * timer (unless a sync will) */
+            else if (cfg->interval != old_interval) {
+                poll_reset();
+                if (cx_enabled && sync.phase == SYNC_IDLE)
+                    clock_event_in(CLOCK_EV_SYNC, get_next_interval() * 1000,
+                                   sync_due);
             }
         }
     }
@@ -605,21 +1340,48 @@ int main(int argc, char **argv)
     if (!network_init())
         goto cleanup;
 
+    /* Not fatal: without it names are resolved on this task */
+    if (!resolver_init())
+        window_log("WARNING: Resolver process unavailable");
+
     if (!clock_init())
         goto cleanup;
 
+    /* Until the first sync, take the clock to be on the configured
+     * zone */
+    {
+        ULONG now, micro;
+        const TZEntry *tz = tz_find_by_name(config_get()->tz_name);
+
+        clock_get_system_time(&now, &micro);
+        clock_set_utc_offset((LONG)(now - (sntp_amiga_to_ntp(now, tz) -
+                                           NTP_TO_AMIGA_EPOCH)));
+    }
+
+    /* Last-known-good server addresses from before the reboot */
+    dnscache_load();
+    ready_init();
+
+    /* Frequency, poll interval and best server learned last session */
+    state_load();
+
     if (!setup_commodity(argc, argv))
         goto cleanup;
 
+    /* Signal used by the sync state machine to schedule its next step */
+    sync_sigbit = AllocSignal(-1);
+    if (sync_sigbit == -1)
+        goto cleanup;
+
     /* Schedule initial sync immediately (1 second intervals until first success) */
     if (cx_enabled) {
         ULONG now, micro;
-        clock_get_system_time(&now, &micro);
+        clock_get_utc(&now, &micro);
         sync_status.next_sync_secs = now + STARTUP_RETRY_INTERVAL;
-        clock_format_time(sync_status.next_sync_secs, sync_status.next_sync_text,
-                          sizeof(sync_status.next_sync_text));
+        refresh_status_times();
         strcpy(sync_status.status_text, "Waiting for network...");
-        clock_start_timer(STARTUP_RETRY_INTERVAL);
+        clock_event_in(CLOCK_EV_SYNC, STARTUP_RETRY_INTERVAL * 1000,
+                       sync_due);
     }
 
     /* Run event loop */
@@ -629,9 +1391,14 @@ int main(int argc, char **argv)
 
 cleanup:
     window_close();
-    clock_abort_timer();
+    clock_event_cancel(CLOCK_EV_SYNC);
+    sync_abort();
+    state_flush();
+    if (sync_sigbit != -1)
+        FreeSignal(sync_sigbit);
     cleanup_commodity();
     clock_cleanup();
+    resolver_cleanup();
     network_cleanup();
     config_cleanup();
     close_libraries();
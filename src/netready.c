@@ -0,0 +1,198 @@
+/* netready.c - Network readiness detection for SyncTime
+ *
+ * Until the first successful sync the commodity used to run a full
+ * resolve-send-receive cycle every second, which kept the CPU awake
+ * and flooded the log on machines that boot without a network. Now
+ * each timer tick, every READY_PROBE_MS, first asks network_probe()
+ * whether the stack is up and only then lets a sync start:
+ *
+ *  - bsdsocket.library not in memory: look for it on every tick, which
+ *    is a list search, but only let OpenLibrary() search LIBS: on disk
+ *    with exponential backoff. A stack started later is seen at once.
+ *  - library open, no IPv4 address yet: re-probe on every tick; this
+ *    costs a single ioctl, and keeps the first sync within about a
+ *    second of the interface coming up.
+ *  - network up but syncs fail: back off between NTP attempts up to
+ *    half a minute, still probing every tick so a change of address
+ *    starts over at once. Only the first failure is logged; the retries
+ *    run quietly (see ready_quiet()) until one succeeds.
+ *
+ * Delays are jittered by +/-25% so that machines booted together do
+ * not hit the servers in lockstep.
+ */
+
+#include "synctime.h"
+
+/* Interface probe cadence */
+#define READY_PROBE_MS     1000
+
+/* bsdsocket.library loads from disk */
+#define READY_LIB_MIN_MS   1000
+#define READY_LIB_MAX_MS   64000
+
+/* NTP attempts on an interface that is up */
+#define READY_NTP_MIN_MS   2000
+#define READY_NTP_MAX_MS   32000
+
+/* =========================================================================
+ * Static module state
+ * ========================================================================= */
+
+static LONG  net_state  = -1;         /* Last network_probe() result */
+static ULONG net_sig    = 0;          /* Last interface signature */
+static ULONG lib_delay  = 0;          /* Current library backoff, ms, 0 = none */
+static ULONG lib_wait   = 0;          /* lib_delay with jitter applied */
+static ULONG lib_secs, lib_micro;     /* When the library backoff started */
+static ULONG ntp_delay  = 0;          /* Current NTP backoff, ms, 0 = none */
+static ULONG ntp_wait   = 0;          /* ntp_delay with jitter applied */
+static ULONG ntp_secs, ntp_micro;     /* When the NTP backoff started */
+static ULONG rand_state = 1;
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+/* Helper: xorshift32, no multiply needed on the 68000 */
+static ULONG next_rand(void)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+/* Helper: delay_ms scaled by a random factor in [0.75, 1.25) */
+static ULONG jitter(ULONG delay_ms)
+{
+    return delay_ms - delay_ms / 4 +
+           ((delay_ms / 2) >> 8) * (next_rand() & 0xFF);
+}
+
+/* Helper: double a backoff delay, starting at min_ms, capped at max_ms */
+static ULONG backoff(ULONG delay_ms, ULONG min_ms, ULONG max_ms)
+{
+    if (delay_ms < min_ms)
+        return min_ms;
+    if (delay_ms >= max_ms / 2)
+        return max_ms;
+    return delay_ms * 2;
+}
+
+/* Helper: milliseconds since a backoff started at start_secs/micro */
+static ULONG elapsed_ms(ULONG start_secs, ULONG start_micro)
+{
+    ULONG secs, micro;
+
+    clock_get_utc(&secs, &micro);
+    if (secs < start_secs)
+        return 0xFFFFFFFFUL;  /* Clock went back: treat as expired */
+    return (secs - start_secs) * 1000 + micro / 1000 - start_micro / 1000;
+}
+
+/* Helper: log a change of network state */
+static void log_state(LONG state)
+{
+    if (state == net_state)
+        return;
+
+    switch (state) {
+        case NET_NO_LIBRARY:
+            window_log("Waiting for bsdsocket.library...");
+            break;
+        case NET_NO_INTERFACE:
+            window_log("Waiting for a network interface...");
+            break;
+        case NET_UP:
+            window_log("Network is up");
+            break;
+    }
+    net_state = state;
+}
+
+/* =========================================================================
+ * Public API
+ * ========================================================================= */
+
+/* ready_init: seed the jitter from the clock */
+void ready_init(void)
+{
+    ULONG secs, micro;
+
+    clock_get_utc(&secs, &micro);
+    rand_state = (secs ^ (micro << 12) ^ (ULONG)FindTask(NULL)) | 1;
+}
+
+/*
+ * ready_check - Probe the network and decide whether to sync now
+ *
+ * Returns TRUE if a sync should start. Otherwise *delay_ms is set to
+ * how long to wait before checking again.
+ */
+BOOL ready_check(ULONG *delay_ms)
+{
+    ULONG sig, waited;
+    BOOL load;
+    LONG state;
+
+    /* Load from disk only once the library backoff has run out */
+    load = (lib_delay == 0 || elapsed_ms(lib_secs, lib_micro) >= lib_wait);
+    state = network_probe(&sig, load);
+    log_state(state);
+
+    if (state == NET_NO_LIBRARY) {
+        if (load) {
+            lib_delay = backoff(lib_delay, READY_LIB_MIN_MS,
+                                READY_LIB_MAX_MS);
+            lib_wait = jitter(lib_delay);
+            clock_get_utc(&lib_secs, &lib_micro);
+        }
+        *delay_ms = READY_PROBE_MS;
+        return FALSE;
+    }
+    lib_delay = 0;
+
+    if (state == NET_NO_INTERFACE) {
+        net_sig = 0;
+        *delay_ms = READY_PROBE_MS;
+        return FALSE;
+    }
+
+    /* New or changed address: earlier failures no longer count */
+    if (sig != net_sig) {
+        net_sig = sig;
+        ntp_delay = 0;
+    }
+
+    if (ntp_delay != 0) {
+        waited = elapsed_ms(ntp_secs, ntp_micro);
+        if (waited < ntp_wait) {
+            waited = ntp_wait - waited;
+            *delay_ms = (waited < READY_PROBE_MS) ? waited : READY_PROBE_MS;
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* ready_quiet: TRUE while retrying after a failure that was logged */
+BOOL ready_quiet(void)
+{
+    return (ntp_delay != 0);
+}
+
+/* ready_report: record the outcome of a sync started after ready_check() */
+void ready_report(BOOL ok)
+{
+    if (ok) {
+        ntp_delay = 0;
+        return;
+    }
+
+    if (ntp_delay == 0)
+        window_log("Retrying in the background, errors not shown");
+
+    ntp_delay = backoff(ntp_delay, READY_NTP_MIN_MS, READY_NTP_MAX_MS);
+    ntp_wait = jitter(ntp_delay);
+    clock_get_utc(&ntp_secs, &ntp_micro);
+}
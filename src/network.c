@@ -2,18 +2,43 @@
  *
  * Wraps bsdsocket.library for UDP communication:
  * DNS resolve, send, receive with timeout.
+ *
+ * Each server being queried gets its own socket "slot" (0 to
+ * MAX_SERVERS - 1), so replies from several servers can be waited on
+ * with a single WaitSelect() call. A slot's socket is created once,
+ * connect()ed to its server where the stack allows it, and reused for
+ * every request until an error or a change of server address; on a
+ * slow stack that socket churn would otherwise cost more than the
+ * NTP exchange itself.
  */
 
 #include "synctime.h"
 
+#include <exec/execbase.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netdb.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
 #include <proto/socket.h>
 
-/* Static state: current socket file descriptor, -1 when not open */
-static LONG sock_fd = -1;
+/* Static state: socket file descriptor per slot, -1 when not open */
+static LONG sock_fd[MAX_SERVERS];
+
+/* Server the slot's socket was set up for, and whether it is connected */
+static ULONG sock_ip[MAX_SERVERS];
+static UWORD sock_port[MAX_SERVERS];
+static BOOL  sock_connected[MAX_SERVERS];
+
+/* bsdsocket.library calls made, see network_socket_ops() */
+static ULONG sock_ops = 0;
+
+/* Socket kept for network_probe()'s interface queries, -1 when not open */
+static LONG probe_fd = -1;
+
+/* Interfaces network_probe() looks at */
+#define PROBE_MAX_IFS 8
 
 /*
  * network_init - Initialize network subsystem
@@ -25,7 +50,10 @@ static LONG sock_fd = -1;
  */
 BOOL network_init(void)
 {
-    sock_fd = -1;
+    ULONG i;
+
+    for (i = 0; i < MAX_SERVERS; i++)
+        sock_fd[i] = -1;
     SocketBase = NULL;
     return TRUE;
 }
@@ -34,29 +62,46 @@ BOOL network_init(void)
  * network_ensure_open - Open bsdsocket.library if not already open
  *
  * Opens any version of bsdsocket.library (version 0) since
- * different TCP/IP stacks (Roadshow, AmiTCP, Miami) may vary.
+ * different TCP/IP stacks (Roadshow, AmiTCP, Miami) may vary. With
+ * load FALSE the library is only opened if it is already in memory,
+ * so a failed attempt costs a list search instead of a scan of LIBS:.
  *
  * Returns TRUE if library is open, FALSE if it cannot be opened.
  */
-static BOOL network_ensure_open(void)
+static BOOL network_ensure_open(BOOL load)
 {
+    struct Node *lib;
+
     if (SocketBase != NULL)
         return TRUE;
 
+    if (!load) {
+        Forbid();
+        lib = FindName(&SysBase->LibList, "bsdsocket.library");
+        Permit();
+        if (lib == NULL)
+            return FALSE;
+    }
+
     SocketBase = OpenLibrary("bsdsocket.library", 0);
     return (SocketBase != NULL);
 }
 
 /*
- * network_cleanup - Close socket and bsdsocket.library
+ * network_cleanup - Close sockets and bsdsocket.library
  *
- * Closes any open socket and releases bsdsocket.library.
+ * Closes any open sockets and releases bsdsocket.library.
  */
 void network_cleanup(void)
 {
-    if (sock_fd >= 0) {
-        CloseSocket(sock_fd);
-        sock_fd = -1;
+    ULONG i;
+
+    for (i = 0; i < MAX_SERVERS; i++)
+        network_close_udp(i);
+
+    if (probe_fd >= 0) {
+        CloseSocket(probe_fd);
+        probe_fd = -1;
     }
 
     if (SocketBase) {
@@ -66,81 +111,146 @@ void network_cleanup(void)
 }
 
 /*
- * network_resolve - Resolve hostname to IPv4 address
+ * network_resolve - Resolve hostname to IPv4 addresses
  *
- * Uses gethostbyname() from bsdsocket.library to resolve
- * the given hostname. The result is in network byte order.
+ * Uses gethostbyname() from bsdsocket.library to resolve the given
+ * hostname and copies up to max of the returned addresses, in
+ * network byte order, to addrs[].
  *
- * Returns TRUE on success, FALSE on failure.
+ * Returns the number of addresses, 0 on failure.
  */
-BOOL network_resolve(const char *hostname, ULONG *ip_addr)
+ULONG network_resolve(const char *hostname, ULONG *addrs, ULONG max)
 {
     struct hostent *h;
+    ULONG n;
 
-    if (!network_ensure_open())
-        return FALSE;
+    if (!network_ensure_open(TRUE))
+        return 0;
 
     h = gethostbyname((STRPTR)hostname);
     if (h == NULL)
+        return 0;
+
+    for (n = 0; n < max && h->h_addr_list[n] != NULL; n++)
+        memcpy(&addrs[n], h->h_addr_list[n], sizeof(ULONG));
+    return n;
+}
+
+/*
+ * network_close_udp - Close the socket of a slot, if open
+ */
+void network_close_udp(ULONG slot)
+{
+    if (slot < MAX_SERVERS && sock_fd[slot] >= 0) {
+        CloseSocket(sock_fd[slot]);
+        sock_ops++;
+        sock_fd[slot] = -1;
+    }
+}
+
+/*
+ * network_open_slot - Create a slot's socket for a server
+ *
+ * The socket is non-blocking, so stale datagrams can be drained
+ * before each request, and connect()ed to the server so that send()
+ * and recv() need no address and the stack drops datagrams from
+ * anyone else. Stacks that refuse connect() on UDP get an unconnected
+ * socket and sendto() instead.
+ *
+ * Returns TRUE on success, FALSE on failure.
+ */
+static BOOL network_open_slot(ULONG slot, ULONG ip_addr, UWORD port)
+{
+    struct sockaddr_in dest;
+    LONG one = 1;
+
+    sock_fd[slot] = socket(AF_INET, SOCK_DGRAM, 0);
+    sock_ops++;
+    if (sock_fd[slot] < 0)
         return FALSE;
 
-    memcpy(ip_addr, h->h_addr_list[0], sizeof(ULONG));
+    IoctlSocket(sock_fd[slot], FIONBIO, (char *)&one);
+    sock_ops++;
+
+    memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(port);    /* Convert to network byte order */
+    dest.sin_addr.s_addr = ip_addr; /* already in network byte order */
+
+    sock_connected[slot] = (connect(sock_fd[slot], (struct sockaddr *)&dest,
+                                    sizeof(dest)) == 0);
+    sock_ops++;
+
+    sock_ip[slot] = ip_addr;
+    sock_port[slot] = port;
     return TRUE;
 }
 
 /*
- * network_send_udp - Send a UDP packet
+ * network_send_udp - Send a UDP packet from a slot
  *
- * Creates a new UDP socket (closing any previous one), sets a
- * 5-second receive timeout via SO_RCVTIMEO, builds the destination
- * address, and sends the data.
+ * Reuses the slot's socket if it was set up for the same server,
+ * otherwise (re)creates it. Late replies to earlier requests still
+ * queued on the socket are drained first, so the next receive is the
+ * answer to this request.
  *
- * The socket is kept open after a successful send so that
- * network_recv_udp() can receive the reply.
+ * The socket stays open so that network_wait_udp() /
+ * network_recv_udp() can receive the reply, and for the next request.
+ * A failed send closes it, to be rebuilt next time.
+ *
+ * If sent is non-NULL it gets the local time taken immediately
+ * before the send call, after the drain: the true T1.
  *
  * 68000 is big-endian, same as network byte order, so no
  * byte swapping is needed for port or address values.
  *
  * Returns TRUE on success, FALSE on failure.
  */
-BOOL network_send_udp(ULONG ip_addr, UWORD port,
-                      const UBYTE *data, ULONG len)
+BOOL network_send_udp(ULONG slot, ULONG ip_addr, UWORD port,
+                      const UBYTE *data, ULONG len, ClockStamp *sent)
 {
-    struct timeval tv;
     struct sockaddr_in dest;
+    UBYTE junk[NTP_PACKET_SIZE];
     LONG result;
 
-    if (!network_ensure_open())
-        return FALSE;
-
-    /* Close any previously open socket */
-    if (sock_fd >= 0) {
-        CloseSocket(sock_fd);
-        sock_fd = -1;
-    }
-
-    /* Create UDP socket */
-    sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock_fd < 0)
+    if (slot >= MAX_SERVERS || !network_ensure_open(TRUE))
         return FALSE;
 
-    /* Set receive timeout to 5 seconds */
-    tv.tv_sec = 5;
-    tv.tv_usec = 0;
-    setsockopt(sock_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    /* Rebuild only if the slot now serves a different address */
+    if (sock_fd[slot] >= 0 &&
+        (sock_ip[slot] != ip_addr || sock_port[slot] != port))
+        network_close_udp(slot);
 
-    /* Build destination address */
-    memset(&dest, 0, sizeof(dest));
-    dest.sin_family = AF_INET;
-    dest.sin_port = htons(port);    /* Convert to network byte order */
-    dest.sin_addr.s_addr = ip_addr; /* already in network byte order */
+    if (sock_fd[slot] < 0) {
+        if (!network_open_slot(slot, ip_addr, port))
+            return FALSE;
+    } else {
+        /* Non-blocking: stops at the first empty read */
+        do {
+            result = recv(sock_fd[slot], junk, sizeof(junk), 0);
+            sock_ops++;
+        } while (result >= 0);
+    }
 
     /* Send the packet */
-    result = sendto(sock_fd, (UBYTE *)data, len, 0,
-                    (struct sockaddr *)&dest, sizeof(dest));
+    if (sock_connected[slot]) {
+        if (sent)
+            clock_get_precise_time(sent);
+        result = send(sock_fd[slot], (UBYTE *)data, len, 0);
+    } else {
+        memset(&dest, 0, sizeof(dest));
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(port);
+        dest.sin_addr.s_addr = ip_addr;
+        if (sent)
+            clock_get_precise_time(sent);
+        result = sendto(sock_fd[slot], (UBYTE *)data, len, 0,
+                        (struct sockaddr *)&dest, sizeof(dest));
+    }
+    sock_ops++;
+
     if (result < 0 || (ULONG)result != len) {
-        CloseSocket(sock_fd);
-        sock_fd = -1;
+        network_close_udp(slot);
         return FALSE;
     }
 
@@ -148,56 +258,191 @@ BOOL network_send_udp(ULONG ip_addr, UWORD port,
 }
 
 /*
- * network_recv_udp - Receive a UDP packet with timeout
+ * network_wait_udp - Wait until any of several slots has a reply
  *
- * Receives data on the currently open socket (opened by
- * network_send_udp). Uses WaitSelect() for timeout since
- * SO_RCVTIMEO is not supported by all Amiga TCP/IP stacks.
+ * slots is a bit mask of slots to wait on (bit n = slot n); slots
+ * without an open socket are ignored. Uses a single WaitSelect()
+ * since SO_RCVTIMEO is not supported by all Amiga TCP/IP stacks.
  *
- * The socket is closed after receive (success or failure).
+ * If sigmask is non-NULL, WaitSelect() also returns when any of
+ * those exec signals arrives, and *sigmask is replaced by the
+ * signals that did. This lets the commodity's event loop wait on
+ * sockets and its message ports at the same time. A timeout_ms of
+ * 0 waits without a time limit.
  *
- * Returns number of bytes received, or -1 on error/timeout.
+ * Returns the mask of slots with data ready, or 0 on timeout/error.
  */
-LONG network_recv_udp(UBYTE *buf, ULONG buf_size, ULONG timeout_secs)
+ULONG network_wait_udp(ULONG slots, ULONG timeout_ms, ULONG *sigmask)
 {
     fd_set read_fds;
     struct timeval tv;
-    ULONG sigmask = 0;  /* No additional signals to wait on */
+    ULONG no_signals = 0;
     LONG select_result;
-    LONG result;
+    LONG max_fd = -1;
+    ULONG ready = 0;
+    ULONG i;
 
-    if (sock_fd < 0)
-        return -1;
+    /* Pass a zero mask instead of NULL - some stacks need this */
+    if (sigmask == NULL)
+        sigmask = &no_signals;
+
+    if (!network_ensure_open(TRUE)) {
+        if (*sigmask)
+            *sigmask = Wait(*sigmask);
+        return 0;
+    }
 
-    /* Set up the fd_set for select/WaitSelect */
     FD_ZERO(&read_fds);
-    FD_SET(sock_fd, &read_fds);
+    for (i = 0; i < MAX_SERVERS; i++) {
+        if ((slots & (1UL << i)) && sock_fd[i] >= 0) {
+            FD_SET(sock_fd[i], &read_fds);
+            if (sock_fd[i] > max_fd)
+                max_fd = sock_fd[i];
+        }
+    }
 
     /* Set timeout */
-    tv.tv_sec = timeout_secs;
-    tv.tv_usec = 0;
-
-    /* Wait for data with timeout using WaitSelect.
-     * Pass &sigmask (zero) instead of NULL - some stacks need this.
-     */
-    select_result = WaitSelect(sock_fd + 1, &read_fds, NULL, NULL, &tv, &sigmask);
-
-    if (select_result <= 0) {
-        /* Timeout (0) or error (-1) */
-        CloseSocket(sock_fd);
-        sock_fd = -1;
-        return -1;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+
+    /* Wait for data, a signal, or the timeout. With no sockets this is
+     * simply a timed wait for signals. */
+    select_result = WaitSelect(max_fd + 1, &read_fds, NULL, NULL,
+                               timeout_ms ? &tv : NULL, sigmask);
+    sock_ops++;
+
+    if (select_result <= 0)
+        return 0;  /* Timeout or signal (0) or error (-1) */
+
+    for (i = 0; i < MAX_SERVERS; i++) {
+        if ((slots & (1UL << i)) && sock_fd[i] >= 0 &&
+            FD_ISSET(sock_fd[i], &read_fds))
+            ready |= 1UL << i;
     }
 
-    /* Data is available, receive it */
-    result = recvfrom(sock_fd, buf, buf_size, 0, NULL, NULL);
+    return ready;
+}
+
+/*
+ * network_recv_udp - Receive a UDP packet on a slot
+ *
+ * Call after network_wait_udp() reported the slot ready. The socket
+ * stays open for the next request unless the receive failed. If
+ * received is non-NULL it gets the local time taken as soon as the
+ * receive call returns: T4.
+ *
+ * Returns number of bytes received, or -1 on error.
+ */
+LONG network_recv_udp(ULONG slot, UBYTE *buf, ULONG buf_size,
+                      ClockStamp *received)
+{
+    LONG result;
 
-    /* Close the socket regardless of result */
-    CloseSocket(sock_fd);
-    sock_fd = -1;
+    if (slot >= MAX_SERVERS || sock_fd[slot] < 0)
+        return -1;
+
+    result = recv(sock_fd[slot], buf, buf_size, 0);
+    if (received)
+        clock_get_precise_time(received);
+    sock_ops++;
 
-    if (result < 0)
+    if (result < 0) {
+        /* ICMP refusal, interface gone, ...: rebuild next time */
+        network_close_udp(slot);
         return -1;
+    }
 
     return result;
 }
+
+/*
+ * network_socket_ops - Number of bsdsocket.library calls made
+ *
+ * Counts socket setup, send, receive, drain, wait and close calls, so
+ * the cost of a sync can be logged. If reset is TRUE the counter
+ * starts again from zero after being read.
+ */
+ULONG network_socket_ops(BOOL reset)
+{
+    ULONG ops = sock_ops;
+
+    if (reset)
+        sock_ops = 0;
+    return ops;
+}
+
+/*
+ * network_probe - Cheaply check whether the TCP/IP stack is usable
+ *
+ * Opens bsdsocket.library if needed (from disk only if load is TRUE,
+ * see network_ensure_open()), then lists the configured interfaces
+ * with one SIOCGIFCONF ioctl on a probe socket that stays open
+ * between calls. *signature gets a value that changes whenever
+ * the set of non-loopback IPv4 addresses does, so callers can notice
+ * a network coming up or changing.
+ *
+ * Returns NET_NO_LIBRARY, NET_NO_INTERFACE or NET_UP.
+ */
+LONG network_probe(ULONG *signature, BOOL load)
+{
+    struct ifreq ifs[PROBE_MAX_IFS];
+    struct ifconf ifc;
+    struct ifreq *ifr;
+    struct sockaddr_in *sin;
+    UBYTE *p, *end;
+    ULONG sig = 0;
+    BOOL found = FALSE;
+    LONG len;
+
+    *signature = 0;
+
+    if (!network_ensure_open(load))
+        return NET_NO_LIBRARY;
+
+    if (probe_fd < 0) {
+        probe_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        sock_ops++;
+        if (probe_fd < 0)
+            return NET_NO_INTERFACE;
+    }
+
+    ifc.ifc_len = sizeof(ifs);
+    ifc.ifc_buf = (char *)ifs;
+    sock_ops++;
+    if (IoctlSocket(probe_fd, SIOCGIFCONF, (char *)&ifc) < 0) {
+        CloseSocket(probe_fd);
+        sock_ops++;
+        probe_fd = -1;
+        return NET_NO_INTERFACE;
+    }
+
+    /* Entries are variable length on BSD stacks: the name plus the
+     * address's own sa_len, but never less than a struct sockaddr */
+    p = (UBYTE *)ifc.ifc_buf;
+    end = p + ifc.ifc_len;
+    while (p + sizeof(ifr->ifr_name) + sizeof(struct sockaddr) <= end) {
+        ifr = (struct ifreq *)p;
+        len = ifr->ifr_addr.sa_len;
+        if (len < (LONG)sizeof(struct sockaddr))
+            len = sizeof(struct sockaddr);
+        p += sizeof(ifr->ifr_name) + len;
+
+        if (ifr->ifr_addr.sa_family != AF_INET)
+            continue;
+        sin = (struct sockaddr_in *)&ifr->ifr_addr;
+
+        /* Skip unconfigured (0.0.0.0) and loopback (127/8) addresses */
+        if (sin->sin_addr.s_addr == 0 ||
+            (sin->sin_addr.s_addr >> 24) == 127)
+            continue;
+
+        sig = ((sig << 5) | (sig >> 27)) ^ sin->sin_addr.s_addr;
+        found = TRUE;
+    }
+
+    if (!found)
+        return NET_NO_INTERFACE;
+
+    *signature = sig;
+    return NET_UP;
+}
@@ -0,0 +1,209 @@
+/* ntptime.c - Fixed-point NTP time arithmetic for SyncTime
+ *
+ * Signed 32.32 NTP time values (see NTPTime in synctime.h): add,
+ * subtract, halve, fraction <-> microsecond conversion and Amiga
+ * epoch conversion.
+ *
+ * Nothing here may pull in the libgcc 64-bit helpers (__muldi3,
+ * __udivdi3, ...), which cost thousands of cycles on a plain 68000.
+ * Multiplication by constants is done as multiply-and-shift using
+ * 16x16->32 MULU on the 68000, or a single 32x32->64 MULU.L when
+ * built for a 68020 or better (make CPU=68020).
+ */
+
+#include "synctime.h"
+
+#define MICROS_PER_SEC 1000000UL
+
+/* 2^64 / 10^6 - 4294 * 2^32, rounded up: the fractional part of
+ * 2^32 / 10^6 scaled by 2^32 */
+#define MICRO_TO_FRAC_LO 4154504686UL
+
+#if defined(__mc68020__) || defined(__mc68030__) || \
+    defined(__mc68040__) || defined(__mc68060__)
+#define NTP_HAVE_MULU64 1
+#endif
+
+/* --------------------------------------------------------------------------
+ * mulhi32 - High 32 bits of an unsigned 32x32 product
+ * -------------------------------------------------------------------------- */
+
+static ULONG mulhi32(ULONG a, ULONG b)
+{
+#ifdef NTP_HAVE_MULU64
+    ULONG hi, lo;
+
+    __asm__ ("mulu.l %3,%0:%1"
+             : "=d" (hi), "=d" (lo)
+             : "1" (a), "dmi" (b)
+             : "cc");
+    return hi;
+#else
+    ULONG al = a & 0xFFFF, ah = a >> 16;
+    ULONG bl = b & 0xFFFF, bh = b >> 16;
+    ULONG ll, lh, hl, hh, mid;
+
+    /* Four MULU.W partial products; casts keep GCC off __mulsi3 */
+    ll = (ULONG)(UWORD)al * (UWORD)bl;
+    lh = (ULONG)(UWORD)al * (UWORD)bh;
+    hl = (ULONG)(UWORD)ah * (UWORD)bl;
+    hh = (ULONG)(UWORD)ah * (UWORD)bh;
+
+    /* Carry out of the low word: at most 3 * 0xFFFF, fits easily */
+    mid = (ll >> 16) + (lh & 0xFFFF) + (hl & 0xFFFF);
+
+    return hh + (lh >> 16) + (hl >> 16) + (mid >> 16);
+#endif
+}
+
+/* --------------------------------------------------------------------------
+ * mul32x16 - Low 32 bits of a 32x16 product (two MULU.W)
+ * -------------------------------------------------------------------------- */
+
+static ULONG mul32x16(ULONG a, UWORD b)
+{
+    return (((ULONG)(UWORD)(a >> 16) * b) << 16) +
+           (ULONG)(UWORD)a * b;
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_add - r = a + b
+ * -------------------------------------------------------------------------- */
+
+void ntp_add(NTPTime *r, const NTPTime *a, const NTPTime *b)
+{
+    ULONG frac = a->frac + b->frac;
+
+    r->secs = a->secs + b->secs + (frac < a->frac ? 1 : 0);
+    r->frac = frac;
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_sub - r = a - b
+ *
+ * Seconds wrap modulo 2^32, so differences between two on-wire
+ * timestamps come out right across NTP era boundaries.
+ * -------------------------------------------------------------------------- */
+
+void ntp_sub(NTPTime *r, const NTPTime *a, const NTPTime *b)
+{
+    ULONG frac = a->frac - b->frac;
+
+    r->secs = a->secs - b->secs - (a->frac < b->frac ? 1 : 0);
+    r->frac = frac;
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_half - r = a / 2, rounding toward minus infinity
+ * -------------------------------------------------------------------------- */
+
+void ntp_half(NTPTime *r, const NTPTime *a)
+{
+    ULONG carry = ((ULONG)a->secs & 1) << 31;
+
+    /* Arithmetic shift of the signed seconds without relying on >> */
+    r->secs = (a->secs - (LONG)(a->secs & 1)) / 2;
+    r->frac = (a->frac >> 1) | carry;
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_frac_to_micro - Convert a 32-bit NTP fraction to microseconds
+ *
+ * micro = frac * 10^6 / 2^32, truncated: the high word of one
+ * 32x32 multiply. Result is 0-999999.
+ * -------------------------------------------------------------------------- */
+
+ULONG ntp_frac_to_micro(ULONG frac)
+{
+    return mulhi32(frac, MICROS_PER_SEC);
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_micro_to_frac - Convert microseconds (0-999999) to an NTP fraction
+ *
+ * frac = micro * 2^32 / 10^6 = micro * 4294.967296, rounded up so that
+ * ntp_frac_to_micro() gives back exactly the same microsecond value.
+ * -------------------------------------------------------------------------- */
+
+ULONG ntp_micro_to_frac(ULONG micro)
+{
+    if (micro == 0)
+        return 0;
+
+    return mul32x16(micro, 4294) + mulhi32(micro, MICRO_TO_FRAC_LO) + 1;
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_to_micro - Convert a (small) NTP time difference to microseconds
+ *
+ * Rounds to the nearest microsecond. Saturates at +/-2147 seconds,
+ * which is far beyond any offset or delay we would slew or filter;
+ * larger values are stepped anyway.
+ * -------------------------------------------------------------------------- */
+
+LONG ntp_to_micro(const NTPTime *t)
+{
+    LONG secs = t->secs;
+    ULONG micro;
+
+    /* Half a microsecond is 2147.48 fraction units */
+    if (t->frac >= 0xFFFFFFFFUL - 2147) {
+        secs++;
+        micro = 0;
+    } else {
+        micro = ntp_frac_to_micro(t->frac + 2147);
+    }
+
+    if (secs >= 2147)
+        return 0x7FFFFFFFL;
+    if (secs < -2147)
+        return -0x7FFFFFFFL;
+
+    /* 10^6 = 15625 * 64; |secs| < 2^12 so this is one MULS.W */
+    return ((LONG)(WORD)secs * 15625L) * 64 + (LONG)micro;
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_from_micro - Build an NTP time difference from signed microseconds
+ * -------------------------------------------------------------------------- */
+
+void ntp_from_micro(NTPTime *t, LONG micro)
+{
+    ULONG mag = (micro < 0) ? (ULONG)0 - (ULONG)micro : (ULONG)micro;
+    ULONG secs, rem;
+
+    /* mag / 10^6 as multiply-and-shift: 2^51 / 10^6 rounded up is
+     * exact for every 31-bit dividend. secs < 2^12, so the product
+     * back is one MULU.W and a shift (10^6 = 15625 * 64). */
+    secs = mulhi32(mag, 2251799814UL) >> 19;
+    rem = mag - (((ULONG)(UWORD)secs * 15625UL) << 6);
+
+    t->secs = (LONG)secs;
+    t->frac = ntp_micro_to_frac(rem);
+
+    /* Negate the 64-bit value for negative input */
+    if (micro < 0) {
+        t->secs = -t->secs - (t->frac != 0 ? 1 : 0);
+        t->frac = (ULONG)0 - t->frac;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_to_amiga - Convert an NTP timestamp to Amiga epoch UTC secs/micro
+ * -------------------------------------------------------------------------- */
+
+void ntp_to_amiga(const NTPTime *t, ULONG *secs, ULONG *micro)
+{
+    *secs = (ULONG)t->secs - NTP_TO_AMIGA_EPOCH;
+    *micro = ntp_frac_to_micro(t->frac);
+}
+
+/* --------------------------------------------------------------------------
+ * ntp_from_amiga - Convert Amiga epoch UTC secs/micro to an NTP timestamp
+ * -------------------------------------------------------------------------- */
+
+void ntp_from_amiga(NTPTime *t, ULONG secs, ULONG micro)
+{
+    t->secs = (LONG)(secs + NTP_TO_AMIGA_EPOCH);
+    t->frac = ntp_micro_to_frac(micro);
+}
@@ -0,0 +1,141 @@
+/* poll.c - Adaptive poll interval for SyncTime
+ *
+ * Works like NTP's poll exponent (RFC 5905 section 13): after each
+ * successful sync the measured offset and jitter are judged. A run of
+ * small, steady results doubles the interval; an offset well outside
+ * the noise, or a jump in jitter, halves it. The interval starts at
+ * the configured INTERVAL and stays within POLL_MIN..POLL_MAX, so a
+ * stable machine polls up to 16x less often while an emulator or an
+ * accelerator card with a wandering clock gets corrected sooner.
+ *
+ * Pure bookkeeping: no I/O besides the log line on a change.
+ */
+
+#include "synctime.h"
+
+/* Offsets below POLL_GATE times the jitter count as steady */
+#define POLL_GATE          4
+
+/* Jitter is never taken below the timestamp floor, in microseconds
+ * (see MIN_DISTANCE in filter.c) */
+#define POLL_MIN_JITTER    1000UL
+
+/* Hysteresis: steady syncs needed to double, credit lost per bad one */
+#define POLL_LIMIT         4
+#define POLL_BAD_COST      2
+
+/* =========================================================================
+ * Static module state
+ * ========================================================================= */
+
+static ULONG poll_secs  = 0;          /* Current interval, 0 = not set yet */
+static LONG  poll_count = 0;          /* Hysteresis counter */
+static ULONG avg_jitter = 0;          /* Running average jitter, us */
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+/* Helper: clamp a value into the configured poll bounds */
+static ULONG clamp_poll(ULONG secs)
+{
+    SyncConfig *cfg = config_get();
+
+    if (secs < (ULONG)cfg->poll_min)
+        secs = (ULONG)cfg->poll_min;
+    if (secs > (ULONG)cfg->poll_max)
+        secs = (ULONG)cfg->poll_max;
+    return secs;
+}
+
+/* Helper: log "Poll interval <n>s" after a change */
+static void log_poll(void)
+{
+    char msg[32];
+    char tmp[12];
+    ULONG val = poll_secs;
+    int i = 0, pos;
+
+    strcpy(msg, "Poll interval ");
+    pos = 14;
+    do {
+        tmp[i++] = '0' + (char)(val % 10);
+        val /= 10;
+    } while (val > 0);
+    while (i > 0)
+        msg[pos++] = tmp[--i];
+    msg[pos++] = 's';
+    msg[pos] = '\0';
+
+    window_log(msg);
+}
+
+/* =========================================================================
+ * Public API
+ * ========================================================================= */
+
+/* poll_reset: start over from the configured interval */
+void poll_reset(void)
+{
+    poll_secs = clamp_poll((ULONG)config_get()->interval);
+    poll_count = 0;
+    avg_jitter = 0;
+}
+
+/* poll_interval: seconds until the next sync after a successful one */
+ULONG poll_interval(void)
+{
+    if (poll_secs == 0)
+        poll_reset();
+
+    /* Bounds may have been edited since the last update */
+    return clamp_poll(poll_secs);
+}
+
+/* poll_set: resume from a saved interval (state.c) */
+void poll_set(ULONG secs)
+{
+    poll_secs = clamp_poll(secs);
+    poll_count = 0;
+}
+
+/*
+ * poll_update - Adjust the interval after a successful sync
+ *
+ * offset_us is the correction just applied, jitter_us the combined
+ * jitter of the servers used.
+ */
+void poll_update(LONG offset_us, ULONG jitter_us)
+{
+    ULONG old = poll_interval();
+    ULONG mag = (offset_us < 0) ? (ULONG)-offset_us : (ULONG)offset_us;
+    BOOL steady;
+
+    if (jitter_us < POLL_MIN_JITTER)
+        jitter_us = POLL_MIN_JITTER;
+
+    /* A jitter spike counts against the interval just like a large
+     * offset; compare before it is averaged in */
+    steady = (mag < POLL_GATE * jitter_us) &&
+             (avg_jitter == 0 || jitter_us <= 2 * avg_jitter);
+
+    avg_jitter = (avg_jitter == 0) ? jitter_us
+                                   : avg_jitter - avg_jitter / 4 + jitter_us / 4;
+
+    if (steady) {
+        poll_count++;
+        if (poll_count >= POLL_LIMIT) {
+            poll_secs = clamp_poll(old * 2);
+            poll_count = 0;
+        }
+    } else {
+        poll_count -= POLL_BAD_COST;
+        if (poll_count <= -POLL_LIMIT || mag >= 2 * POLL_GATE * jitter_us) {
+            poll_secs = clamp_poll(old / 2);
+            poll_count = 0;
+        }
+    }
+
+    if (poll_secs != old)
+        log_poll();
+}
@@ -0,0 +1,322 @@
+/* resolver.c - Asynchronous DNS resolver process for SyncTime
+ *
+ * gethostbyname() blocks for as long as the resolver takes, which can
+ * be tens of seconds with a missing or unreachable DNS server. To keep
+ * the commodity responsive, lookups run in a small child process with
+ * its own bsdsocket.library base. The main task sends ResolveMsg
+ * requests to the child's port and gets them back, filled in, on
+ * reply_port, whose signal sits in event_loop()'s Wait() mask.
+ *
+ * Cancelling bumps a generation counter: the child skips queued
+ * requests of an older generation, an in-flight lookup is broken off
+ * with SIGBREAKF_CTRL_C (the child's socket break mask), and stale
+ * replies are dropped when collected.
+ */
+
+#include "synctime.h"
+
+#include <dos/dostags.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <proto/socket.h>
+#include <libraries/bsdsocket.h>
+
+/* Request commands */
+#define RESOLVER_LOOKUP  0
+#define RESOLVER_QUIT    1
+
+/* Child process stack */
+#define RESOLVER_STACK   8192
+
+/* One request/reply */
+struct ResolveMsg {
+    struct Message msg;
+    UBYTE  command;                 /* RESOLVER_* */
+    ULONG  id;                      /* Caller's tag, returned unchanged */
+    ULONG  gen;                     /* Generation at request time */
+    ULONG  count;                   /* Reply: addresses found, 0 = failed */
+    ULONG  addrs[DNS_MAX_ADDRS];    /* Reply: network byte order */
+    char   name[SERVER_NAME_MAX];
+};
+
+/* Startup handshake: the child creates its port and hands it back */
+struct ResolverStartup {
+    struct Message  msg;
+    struct MsgPort *port;
+};
+
+/* --------------------------------------------------------------------------
+ * Static state (shared with the child; it only reads current_gen)
+ * -------------------------------------------------------------------------- */
+
+static struct Process *child        = NULL;
+static struct MsgPort *child_port   = NULL;
+static struct MsgPort *reply_port   = NULL;
+static volatile ULONG  current_gen  = 0;
+static ULONG           outstanding  = 0;  /* Requests not yet replied */
+
+/* --------------------------------------------------------------------------
+ * resolver_child - Entry point of the resolver process
+ *
+ * SocketBase is a local here on purpose: bsdsocket.library bases are
+ * per task, and the proto/socket.h calls pick up this one instead of
+ * the main task's global.
+ * -------------------------------------------------------------------------- */
+
+static void resolver_child(void)
+{
+    struct Library *SocketBase = NULL;
+    struct Process *me = (struct Process *)FindTask(NULL);
+    struct ResolverStartup *startup;
+    struct ResolveMsg *rm;
+    struct ResolveMsg *quit_msg = NULL;
+    struct MsgPort *port;
+    struct hostent *h;
+
+    /* Wait for the startup message from resolver_init() */
+    WaitPort(&me->pr_MsgPort);
+    startup = (struct ResolverStartup *)GetMsg(&me->pr_MsgPort);
+
+    port = CreateMsgPort();
+    startup->port = port;
+    if (port == NULL) {
+        Forbid();
+        ReplyMsg((struct Message *)startup);
+        return;
+    }
+    ReplyMsg((struct Message *)startup);
+
+    while (quit_msg == NULL) {
+        WaitPort(port);
+        while ((rm = (struct ResolveMsg *)GetMsg(port)) != NULL) {
+            if (rm->command == RESOLVER_QUIT) {
+                quit_msg = rm;
+                continue;
+            }
+
+            rm->count = 0;
+
+            /* Cancelled while queued */
+            if (rm->gen != current_gen || quit_msg != NULL) {
+                ReplyMsg((struct Message *)rm);
+                continue;
+            }
+
+            /* Open lazily: the stack may come up after SyncTime */
+            if (SocketBase == NULL) {
+                SocketBase = OpenLibrary("bsdsocket.library", 0);
+                if (SocketBase != NULL)
+                    SocketBaseTags(SBTM_SETVAL(SBTC_BREAKMASK),
+                                   SIGBREAKF_CTRL_C, TAG_DONE);
+            }
+
+            if (SocketBase != NULL) {
+                /* Drop a cancel meant for an earlier lookup */
+                SetSignal(0, SIGBREAKF_CTRL_C);
+
+                h = gethostbyname((STRPTR)rm->name);
+                while (h != NULL && rm->count < DNS_MAX_ADDRS &&
+                       h->h_addr_list[rm->count] != NULL) {
+                    memcpy(&rm->addrs[rm->count],
+                           h->h_addr_list[rm->count], sizeof(ULONG));
+                    rm->count++;
+                }
+            }
+
+            ReplyMsg((struct Message *)rm);
+        }
+    }
+
+    if (SocketBase != NULL)
+        CloseLibrary(SocketBase);
+    DeleteMsgPort(port);
+
+    /* Reply under Forbid() so our code cannot be unloaded before we
+     * have actually returned */
+    Forbid();
+    ReplyMsg((struct Message *)quit_msg);
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_init - Start the resolver process
+ *
+ * Returns FALSE if the process could not be started; callers then
+ * fall back to blocking network_resolve().
+ * -------------------------------------------------------------------------- */
+
+BOOL resolver_init(void)
+{
+    struct ResolverStartup startup;
+
+    reply_port = CreateMsgPort();
+    if (reply_port == NULL)
+        return FALSE;
+
+    child = CreateNewProcTags(NP_Entry,     (ULONG)resolver_child,
+                              NP_Name,      (ULONG)"SyncTime resolver",
+                              NP_StackSize, RESOLVER_STACK,
+                              TAG_DONE);
+    if (child == NULL) {
+        resolver_cleanup();
+        return FALSE;
+    }
+
+    /* Handshake: wait for the child to report its port */
+    memset(&startup, 0, sizeof(startup));
+    startup.msg.mn_ReplyPort = reply_port;
+    startup.msg.mn_Length = sizeof(startup);
+    PutMsg(&child->pr_MsgPort, (struct Message *)&startup);
+    WaitPort(reply_port);
+    GetMsg(reply_port);
+
+    child_port = startup.port;
+    if (child_port == NULL) {
+        child = NULL;  /* Child has already exited */
+        resolver_cleanup();
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_cleanup - Stop the child and free everything
+ * -------------------------------------------------------------------------- */
+
+void resolver_cleanup(void)
+{
+    struct ResolveMsg quit;
+    struct Message *msg;
+
+    if (child_port != NULL) {
+        resolver_cancel();
+
+        memset(&quit, 0, sizeof(quit));
+        quit.msg.mn_ReplyPort = reply_port;
+        quit.msg.mn_Length = sizeof(quit);
+        quit.command = RESOLVER_QUIT;
+        PutMsg(child_port, (struct Message *)&quit);
+
+        /* Collect every outstanding request; the quit reply comes last */
+        for (;;) {
+            WaitPort(reply_port);
+            msg = GetMsg(reply_port);
+            if (msg == (struct Message *)&quit)
+                break;
+            FreeVec(msg);
+        }
+
+        child_port = NULL;
+        child = NULL;
+        outstanding = 0;
+    }
+
+    if (reply_port != NULL) {
+        while ((msg = GetMsg(reply_port)) != NULL)
+            FreeVec(msg);
+        DeleteMsgPort(reply_port);
+        reply_port = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_available - TRUE if lookups can be done asynchronously
+ * -------------------------------------------------------------------------- */
+
+BOOL resolver_available(void)
+{
+    return (child_port != NULL);
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_signal - Signal mask of the reply port
+ * -------------------------------------------------------------------------- */
+
+ULONG resolver_signal(void)
+{
+    if (reply_port)
+        return 1UL << reply_port->mp_SigBit;
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_request - Queue a lookup; the reply carries id back
+ * -------------------------------------------------------------------------- */
+
+BOOL resolver_request(ULONG id, const char *hostname)
+{
+    struct ResolveMsg *rm;
+    LONG i;
+
+    if (child_port == NULL)
+        return FALSE;
+
+    rm = AllocVec(sizeof(*rm), MEMF_PUBLIC | MEMF_CLEAR);
+    if (rm == NULL)
+        return FALSE;
+
+    rm->msg.mn_ReplyPort = reply_port;
+    rm->msg.mn_Length = sizeof(*rm);
+    rm->command = RESOLVER_LOOKUP;
+    rm->id = id;
+    rm->gen = current_gen;
+    for (i = 0; i < SERVER_NAME_MAX - 1 && hostname[i] != '\0'; i++)
+        rm->name[i] = hostname[i];
+    rm->name[i] = '\0';
+
+    PutMsg(child_port, (struct Message *)rm);
+    outstanding++;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_get_reply - Fetch one finished lookup (non-blocking)
+ *
+ * Copies the addresses found (at most DNS_MAX_ADDRS) to addrs[] and
+ * their number, 0 if the lookup failed, to *count. Replies to
+ * cancelled requests are discarded. Returns FALSE when no current
+ * reply is waiting.
+ * -------------------------------------------------------------------------- */
+
+BOOL resolver_get_reply(ULONG *id, ULONG *addrs, ULONG *count)
+{
+    struct ResolveMsg *rm;
+    ULONG i;
+
+    if (reply_port == NULL)
+        return FALSE;
+
+    while ((rm = (struct ResolveMsg *)GetMsg(reply_port)) != NULL) {
+        outstanding--;
+
+        if (rm->gen != current_gen) {
+            FreeVec(rm);
+            continue;
+        }
+
+        *id = rm->id;
+        *count = rm->count;
+        for (i = 0; i < rm->count; i++)
+            addrs[i] = rm->addrs[i];
+        FreeVec(rm);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------
+ * resolver_cancel - Abandon every outstanding lookup
+ * -------------------------------------------------------------------------- */
+
+void resolver_cancel(void)
+{
+    current_gen++;
+
+    /* Break off a lookup in progress */
+    if (child != NULL && outstanding > 0)
+        Signal((struct Task *)child, SIGBREAKF_CTRL_C);
+}
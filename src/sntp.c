@@ -12,27 +12,54 @@
 #define NTP_MODE_SERVER    4
 #define NTP_MODE_BROADCAST 5
 
+/*
+ * Helpers: big-endian 32-bit load/store at a packet offset
+ */
+static ULONG get_be32(const UBYTE *p)
+{
+    return ((ULONG)p[0] << 24) |
+           ((ULONG)p[1] << 16) |
+           ((ULONG)p[2] << 8)  |
+           ((ULONG)p[3]);
+}
+
+static void put_be32(UBYTE *p, ULONG v)
+{
+    p[0] = (UBYTE)(v >> 24);
+    p[1] = (UBYTE)(v >> 16);
+    p[2] = (UBYTE)(v >> 8);
+    p[3] = (UBYTE)v;
+}
+
 /*
  * sntp_build_request - Build an SNTP client request packet
  *
- * Zeroes all 48 bytes and sets the LI/Version/Mode byte to
- * indicate NTPv3 client mode (0x1B).
+ * Zeroes all 48 bytes, sets the LI/Version/Mode byte to indicate
+ * NTPv3 client mode (0x1B) and stamps T1 (our local send time, NTP
+ * epoch) into the transmit timestamp. The server echoes it back in
+ * the origin timestamp so the reply can be matched to this request.
  */
-void sntp_build_request(UBYTE *packet)
+void sntp_build_request(UBYTE *packet, const NTPTime *t1)
 {
     memset(packet, 0, NTP_PACKET_SIZE);
     packet[0] = (NTP_VERSION << 3) | NTP_MODE_CLIENT;  /* 0x1B */
+
+    put_be32(packet + 40, (ULONG)t1->secs);
+    put_be32(packet + 44, t1->frac);
 }
 
 /*
  * sntp_parse_response - Parse an SNTP server response packet
  *
- * Validates the response mode and stratum, then extracts the
- * transmit timestamp (bytes 40-47) as big-endian 32-bit values.
+ * Validates the response mode and stratum, checks that the origin
+ * timestamp (bytes 24-31) echoes the T1 already stored in ts, then
+ * extracts the receive (T2, bytes 32-39) and transmit (T3, bytes
+ * 40-47) timestamps as big-endian 32-bit values.
  *
- * Returns TRUE on success, FALSE if the packet is invalid.
+ * Returns TRUE on success, FALSE if the packet is invalid or does
+ * not answer our request.
  */
-BOOL sntp_parse_response(const UBYTE *packet, ULONG *ntp_secs, ULONG *ntp_frac)
+BOOL sntp_parse_response(const UBYTE *packet, SNTPTimestamps *ts)
 {
     UBYTE mode;
     UBYTE stratum;
@@ -51,27 +78,74 @@ BOOL sntp_parse_response(const UBYTE *packet, ULONG *ntp_secs, ULONG *ntp_frac)
     if (stratum == 0)
         return FALSE;
 
-    /* Extract transmit timestamp seconds (bytes 40-43, big-endian) */
-    secs = ((ULONG)packet[40] << 24) |
-           ((ULONG)packet[41] << 16) |
-           ((ULONG)packet[42] << 8)  |
-           ((ULONG)packet[43]);
+    /* Origin timestamp must echo our T1, otherwise this is a stale
+     * or forged reply (bytes 24-31) */
+    if (get_be32(packet + 24) != (ULONG)ts->t1.secs ||
+        get_be32(packet + 28) != ts->t1.frac)
+        return FALSE;
 
-    /* Extract transmit timestamp fraction (bytes 44-47, big-endian) */
-    frac = ((ULONG)packet[44] << 24) |
-           ((ULONG)packet[45] << 16) |
-           ((ULONG)packet[46] << 8)  |
-           ((ULONG)packet[47]);
+    /* Extract transmit timestamp (bytes 40-47, big-endian) */
+    secs = get_be32(packet + 40);
+    frac = get_be32(packet + 44);
 
     /* Server didn't set a transmit timestamp */
     if (secs == 0)
         return FALSE;
 
-    *ntp_secs = secs;
-    *ntp_frac = frac;
+    ts->t3.secs = (LONG)secs;
+    ts->t3.frac = frac;
+
+    /* Extract receive timestamp (bytes 32-39, big-endian) */
+    ts->t2.secs = (LONG)get_be32(packet + 32);
+    ts->t2.frac = get_be32(packet + 36);
+    if (ts->t2.secs == 0)
+        return FALSE;
+
     return TRUE;
 }
 
+/*
+ * sntp_compute_offset - On-wire offset and delay calculation
+ *
+ * Uses the four timestamps of one exchange (RFC 5905 section 8):
+ *
+ *   offset = ((T2 - T1) + (T3 - T4)) / 2
+ *   delay  = (T4 - T1) - (T3 - T2)
+ *
+ * All in 32.32 fixed point via ntptime.c. Each difference is halved
+ * before the sum, so the offset stays right up to +/-2^31 seconds (a
+ * battery-less Amiga booting at 1978) instead of overflowing the
+ * seconds field past 2^30. A negative delay (clock granularity on a
+ * fast LAN) is clamped to zero.
+ *
+ * Returns FALSE if the delay is too large to be a sane sample.
+ */
+BOOL sntp_compute_offset(const SNTPTimestamps *ts, SNTPResult *res)
+{
+    NTPTime a, b;
+
+    /* Offset: (T2 - T1) / 2 + (T3 - T4) / 2 */
+    ntp_sub(&a, &ts->t2, &ts->t1);
+    ntp_sub(&b, &ts->t3, &ts->t4);
+    ntp_half(&a, &a);
+    ntp_half(&b, &b);
+    ntp_add(&res->offset, &a, &b);
+
+    /* Delay: (T4 - T1) minus the server's hold time (T3 - T2) */
+    ntp_sub(&a, &ts->t4, &ts->t1);
+    ntp_sub(&b, &ts->t3, &ts->t2);
+    ntp_sub(&res->delay, &a, &b);
+
+    if (res->delay.secs < 0) {
+        res->delay.secs = 0;
+        res->delay.frac = 0;
+        return TRUE;
+    }
+
+    /* Anything over a minute of round trip is not a usable sample */
+    return (res->delay.secs < 60);
+}
+
 /*
  * sntp_ntp_to_amiga - Convert NTP timestamp to Amiga local time
  *
@@ -93,3 +167,28 @@ ULONG sntp_ntp_to_amiga(ULONG ntp_secs, const TZEntry *tz)
     /* Apply offset (can be negative for western timezones) */
     return (ULONG)((LONG)utc_secs + (offset_mins * 60));
 }
+
+/*
+ * sntp_amiga_to_ntp - Convert Amiga local time to NTP seconds
+ *
+ * Inverse of sntp_ntp_to_amiga(). The offset is looked up at the
+ * standard-time estimate of UTC; within the hour around a DST
+ * transition it may pick the other side. Only used to guess the
+ * offset the clock carries at startup; timestamps are converted with
+ * the offset clock.c knows.
+ */
+ULONG sntp_amiga_to_ntp(ULONG amiga_secs, const TZEntry *tz)
+{
+    ULONG utc_secs;
+    LONG offset_mins;
+
+    utc_secs = amiga_secs;
+    if (tz)
+        utc_secs = (ULONG)((LONG)amiga_secs - (tz->std_offset_mins * 60));
+
+    offset_mins = tz_get_offset_mins(tz, utc_secs);
+    utc_secs = (ULONG)((LONG)amiga_secs - (offset_mins * 60));
+
+    /* Convert from Amiga epoch (1978) to NTP epoch (1900) */
+    return utc_secs + NTP_TO_AMIGA_EPOCH;
+}
@@ -0,0 +1,248 @@
+/* state.c - Persistent discipline state for SyncTime
+ *
+ * Saves what SyncTime has learned about this machine to
+ * ENVARC:SyncTime.state, so a restart does not begin cold: the
+ * frequency correction and its wander (discipline.c), the poll
+ * interval reached (poll.c), the last few offsets and the best server
+ * of the last sync. state_load() puts them back before the first sync.
+ *
+ * Writes are batched: at most once per STATE_WRITE_INTERVAL (the
+ * first one right after the first sync of a session, in case the
+ * machine is reset without a shutdown) and on exit, so floppy and CF
+ * systems are not written to on every sync. The ENVARC: copy of the
+ * DNS cache (dnscache_flush()) goes out with the same writes.
+ *
+ * Same key=value file format and manual number handling as config.c.
+ */
+
+#include "synctime.h"
+
+/* Seconds between batched writes */
+#define STATE_WRITE_INTERVAL 3600
+
+/* Offsets kept */
+#define STATE_OFFSETS      4
+
+/* Restored poll interval is only trusted if the last offsets stayed
+ * below this, microseconds */
+#define STATE_STEADY_US    50000L
+
+/* =========================================================================
+ * Static module state
+ * ========================================================================= */
+
+static LONG  offsets[STATE_OFFSETS];  /* Most recent first */
+static UBYTE offset_count = 0;
+static char  best_name[SERVER_NAME_MAX];
+static ULONG best_ip = 0;
+static BOOL  dirty = FALSE;
+static BOOL  written = FALSE;         /* Written this session */
+static ULONG last_write = 0;          /* UTC seconds */
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+/* Helper: parse a signed integer (manual digit loop) */
+static LONG parse_int(const char *s, const char **end)
+{
+    LONG val = 0;
+    BOOL negative = FALSE;
+
+    if (*s == '-') {
+        negative = TRUE;
+        s++;
+    }
+    while (*s >= '0' && *s <= '9') {
+        val = val * 10 + (*s - '0');
+        s++;
+    }
+    if (end)
+        *end = s;
+
+    return negative ? -val : val;
+}
+
+/* Helper: write a signed integer (manual, no sprintf) */
+static void put_int(BPTR fh, LONG val)
+{
+    char tmp[12];
+    char buf[13];
+    ULONG uval = (val < 0) ? (ULONG)-val : (ULONG)val;
+    int i = 0, pos = 0;
+
+    do {
+        tmp[i++] = '0' + (char)(uval % 10);
+        uval /= 10;
+    } while (uval > 0);
+
+    if (val < 0)
+        buf[pos++] = '-';
+    while (i > 0)
+        buf[pos++] = tmp[--i];
+    buf[pos] = '\0';
+
+    FPuts(fh, buf);
+}
+
+/* Helper: copy a value up to the end of line */
+static void copy_value(char *dst, const char *src, LONG max)
+{
+    LONG i;
+
+    for (i = 0; i < max - 1 && src[i] != '\0' &&
+                src[i] != '\n' && src[i] != '\r'; i++)
+        dst[i] = src[i];
+    dst[i] = '\0';
+}
+
+/* Helper: save everything to the state file */
+static BOOL save_state(void)
+{
+    BPTR fh;
+    LONG ppb;
+    ULONG wander;
+    UBYTE i;
+
+    fh = Open(STATE_ENVARC_PATH, MODE_NEWFILE);
+    if (!fh)
+        return FALSE;
+
+    if (discipline_get_freq(&ppb, &wander)) {
+        FPuts(fh, "FREQ=");
+        put_int(fh, ppb);
+        FPuts(fh, "\nWANDER=");
+        put_int(fh, (LONG)wander);
+        FPuts(fh, "\n");
+    }
+
+    FPuts(fh, "POLL=");
+    put_int(fh, (LONG)poll_interval());
+    FPuts(fh, "\n");
+
+    if (offset_count > 0) {
+        FPuts(fh, "OFFSETS=");
+        for (i = 0; i < offset_count; i++) {
+            if (i > 0)
+                FPuts(fh, ",");
+            put_int(fh, offsets[i]);
+        }
+        FPuts(fh, "\n");
+    }
+
+    if (best_name[0] != '\0') {
+        FPuts(fh, "BEST=");
+        FPuts(fh, best_name);
+        FPuts(fh, "\nBEST_ADDR=");
+        put_int(fh, (LONG)best_ip);
+        FPuts(fh, "\n");
+    }
+
+    Close(fh);
+    return TRUE;
+}
+
+/* =========================================================================
+ * Public API
+ * ========================================================================= */
+
+/* state_load: read ENVARC:SyncTime.state and hand its values back to
+ * the modules they came from. Call after dnscache_load(). */
+void state_load(void)
+{
+    BPTR fh;
+    char line[256];
+    const char *p;
+    LONG freq = 0, wander = 0, poll = 0;
+    BOOL have_freq = FALSE;
+    BOOL steady;
+    UBYTE i;
+
+    fh = Open(STATE_ENVARC_PATH, MODE_OLDFILE);
+    if (!fh)
+        return;
+
+    while (FGets(fh, line, sizeof(line))) {
+        if (strncmp(line, "FREQ=", 5) == 0) {
+            freq = parse_int(line + 5, NULL);
+            have_freq = TRUE;
+        } else if (strncmp(line, "WANDER=", 7) == 0) {
+            wander = parse_int(line + 7, NULL);
+        } else if (strncmp(line, "POLL=", 5) == 0) {
+            poll = parse_int(line + 5, NULL);
+        } else if (strncmp(line, "OFFSETS=", 8) == 0) {
+            p = line + 8;
+            offset_count = 0;
+            while (offset_count < STATE_OFFSETS &&
+                   (*p == '-' || (*p >= '0' && *p <= '9'))) {
+                offsets[offset_count++] = parse_int(p, &p);
+                if (*p == ',')
+                    p++;
+            }
+        } else if (strncmp(line, "BEST=", 5) == 0) {
+            copy_value(best_name, line + 5, SERVER_NAME_MAX);
+        } else if (strncmp(line, "BEST_ADDR=", 10) == 0) {
+            best_ip = (ULONG)parse_int(line + 10, NULL);
+        }
+    }
+
+    Close(fh);
+
+    if (have_freq) {
+        discipline_set_freq(freq, (ULONG)(wander < 0 ? 0 : wander));
+        window_log("Restored frequency correction");
+    }
+
+    /* Only pick up where polling left off if the clock was steady */
+    steady = (offset_count > 0);
+    for (i = 0; i < offset_count; i++) {
+        if (offsets[i] > STATE_STEADY_US || offsets[i] < -STATE_STEADY_US)
+            steady = FALSE;
+    }
+    if (steady && poll > 0)
+        poll_set((ULONG)poll);
+
+    if (best_name[0] != '\0' && best_ip != 0)
+        dnscache_prefer(best_name, best_ip);
+}
+
+/*
+ * state_record - Note the outcome of a successful sync
+ *
+ * Writes the file if it has not been written this session or the
+ * last write is STATE_WRITE_INTERVAL seconds old.
+ */
+void state_record(LONG offset_us, const char *name, ULONG ip_addr)
+{
+    ULONG secs, micro;
+    UBYTE i;
+
+    for (i = STATE_OFFSETS - 1; i > 0; i--)
+        offsets[i] = offsets[i - 1];
+    offsets[0] = offset_us;
+    if (offset_count < STATE_OFFSETS)
+        offset_count++;
+
+    copy_value(best_name, name, SERVER_NAME_MAX);
+    best_ip = ip_addr;
+    dirty = TRUE;
+
+    clock_get_utc(&secs, &micro);
+    if (!written || secs < last_write ||
+        secs - last_write >= STATE_WRITE_INTERVAL) {
+        if (save_state()) {
+            dirty = FALSE;
+            written = TRUE;
+            last_write = secs;
+        }
+        dnscache_flush();
+    }
+}
+
+/* state_flush: write pending changes (at shutdown) */
+void state_flush(void)
+{
+    if (dirty && save_state())
+        dirty = FALSE;
+    dnscache_flush();
+}
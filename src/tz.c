@@ -3,6 +3,11 @@
  * Provides timezone lookup, region/city enumeration, and DST calculation.
  * Works with the generated tz_table[] from tz_table.c.
  *
+ * DST comes from each zone's M.w.d rules, except where they cannot
+ * express what the zone does (fixed dates, Fri>=23 style days, recent
+ * changes): then tz_table.c carries the exact UTC transitions for a
+ * span of years (gen_tz_table.py --years), used inside that span.
+ *
  * Amiga epoch is Jan 1, 1978 00:00:00 UTC.
  */
 
@@ -16,28 +21,38 @@
 #define SECS_PER_HOUR  3600
 #define SECS_PER_DAY   86400
 
-/* Maximum regions (12 should cover all IANA regions) */
-#define MAX_REGIONS    17  /* 16 + 1 for NULL terminator */
+/* Date conversion counts March-based years from 1 March 1900, so
+ * the year fits a word and 2000 and 2100 are the only century years */
+#define BASE_YEAR        1900
 
-/* Maximum cities per region */
-#define MAX_CITIES     200
+/* Days from 1 March 1900 to the Amiga epoch, 1 January 1978 */
+#define EPOCH_BASE_DAYS  28430UL
 
 /* Amiga epoch year */
 #define AMIGA_EPOCH_YEAR 1978
 
+/* tz_transitions[] entry: bit 31 DST, bits 30-24 total UTC offset in
+ * quarter hours (signed), bits 23-0 minutes since tz_trans_from */
+#define TZ_TRANS_DST        0x80000000UL
+#define TZ_TRANS_MINS(t)    ((t) & 0x00FFFFFFUL)
+#define TZ_TRANS_OFFSET(t)  ((LONG)((t) << 1) >> 25)
+
+/* Minutes to seconds with shifts: no 32-bit multiply on the 68000 */
+#define MINS_TO_SECS(m)     (((m) << 6) - ((m) << 2))
+
 /* =========================================================================
  * Static module state
  * ========================================================================= */
 
-/* Cached region list - built on first call to tz_get_regions */
-static const char *region_list[MAX_REGIONS];
-static ULONG region_count = 0;
-static BOOL regions_initialized = FALSE;
-
-/* Cached city list for current region query */
-static const TZEntry *city_list[MAX_CITIES];
-static ULONG city_count = 0;
-static const char *cached_region = NULL;
+/* DST window cache: the period around the last query. For UTC times
+ * in [win_from, win_until) zone win_tz is on DST if win_dst, at
+ * win_offset, so a query inside it costs two compares. */
+static const TZEntry *win_tz = NULL;
+static ULONG win_from = 0;
+static ULONG win_until = 0;
+static BOOL  win_dst = FALSE;
+static LONG  win_offset = 0;           /* UTC offset, minutes */
+static BOOL  win_has_next = FALSE;     /* win_until is a transition */
 
 /* =========================================================================
  * Days in each month (non-leap year)
@@ -47,6 +62,11 @@ static const UBYTE days_in_month[12] = {
     31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
 };
 
+/* Days before each month of a year that starts in March */
+static const UWORD days_before_month[12] = {
+    0, 31, 61, 92, 122, 153, 184, 214, 245, 275, 306, 337
+};
+
 /* =========================================================================
  * Helper: check if year is a leap year
  * ========================================================================= */
@@ -76,37 +96,120 @@ static UBYTE get_days_in_month(LONG year, UBYTE month)
 }
 
 /* =========================================================================
- * Helper: calculate day of week using Zeller's congruence
+ * Helper: DIVU.W - 32/16 bit divide with a 16-bit quotient
  *
- * Returns 0=Sunday, 1=Monday, ... 6=Saturday
+ * The caller makes sure the quotient fits a word. GCC would otherwise
+ * call the libgcc 32-bit divide, which takes hundreds of cycles on a
+ * 68000.
  * ========================================================================= */
 
-static UBYTE day_of_week(LONG year, UBYTE month, UBYTE day)
+static UWORD divu_w(ULONG n, UWORD d, UWORD *rem)
+{
+#ifdef __mc68000__
+    __asm__ ("divu.w %1,%0" : "+d" (n) : "dmi" (d) : "cc");
+    if (rem)
+        *rem = (UWORD)(n >> 16);
+    return (UWORD)n;
+#else
+    if (rem)
+        *rem = (UWORD)(n % d);
+    return (UWORD)(n / d);
+#endif
+}
+
+/* =========================================================================
+ * Helper: days from 1 March 1900 to 1 March of base year y
+ *
+ * 2000 is a leap year and 2100 is not; the next exception is 2200.
+ * One MULU.W, no divide.
+ * ========================================================================= */
+
+static ULONG days_before_year(UWORD y)
+{
+    return (ULONG)y * 365U + (y >> 2) - (y >= 200 ? 1 : 0);
+}
+
+/* =========================================================================
+ * Helper: days since the Amiga epoch for a civil date
+ *
+ * Closed form after Howard Hinnant's days_from_civil(): years are
+ * counted from March, so the leap day is the last day of the year and
+ * the day of the year comes from days_before_month[] alone. Valid from
+ * 1 March 1900 to 28 February 2200; the Amiga clock only needs 1978 to
+ * 2114.
+ * ========================================================================= */
+
+static ULONG days_from_civil(LONG year, UBYTE month, UBYTE day)
 {
-    LONG y, m, q, k, j, h;
+    UWORD doy;
 
-    /* Zeller's congruence treats Jan and Feb as months 13 and 14 of prev year */
-    if (month < 3) {
-        m = month + 12;
-        y = year - 1;
+    if (month <= 2) {
+        year--;
+        doy = days_before_month[month + 9];
     } else {
-        m = month;
-        y = year;
+        doy = days_before_month[month - 3];
+    }
+    doy += day - 1;
+
+    return days_before_year((UWORD)(year - BASE_YEAR)) + doy -
+           EPOCH_BASE_DAYS;
+}
+
+/* =========================================================================
+ * Helper: civil date for a number of days since the Amiga epoch
+ *
+ * Inverse of days_from_civil(). The year is estimated with one
+ * MULU.W as half the days times 359 / 65536, close to 2 / 365.2425,
+ * and moved by at most one against days_before_year(). The month is
+ * estimated as doy / 31, which is at most one short, and corrected
+ * against days_before_month[] the same way.
+ * ========================================================================= */
+
+static void civil_from_days(ULONG days, LONG *year, UBYTE *month, UBYTE *day)
+{
+    ULONG z, start;
+    UWORD y, doy;
+    UBYTE mp, m;
+
+    z = days + EPOCH_BASE_DAYS;
+    y = (UWORD)(((ULONG)(UWORD)(z >> 1) * 359U) >> 16);
+
+    start = days_before_year(y);
+    if (z < start) {
+        y--;
+        start = days_before_year(y);
+    } else if (z >= days_before_year(y + 1)) {
+        y++;
+        start = days_before_year(y);
     }
+    doy = (UWORD)(z - start);                          /* [0, 365] */
+
+    mp = (UBYTE)divu_w(doy, 31, NULL);                 /* March = 0 */
+    if (mp < 11 && doy >= days_before_month[mp + 1])
+        mp++;
+    m = (mp < 10) ? mp + 3 : mp - 9;
 
-    q = day;
-    k = y % 100;
-    j = y / 100;
+    if (year)
+        *year = BASE_YEAR + (LONG)y + (m <= 2 ? 1 : 0);
+    if (month)
+        *month = m;
+    if (day)
+        *day = (UBYTE)(doy - days_before_month[mp] + 1);
+}
 
-    /* Zeller's formula for Gregorian calendar */
-    h = (q + (13 * (m + 1)) / 5 + k + k / 4 + j / 4 - 2 * j) % 7;
+/* =========================================================================
+ * Helper: calculate day of week
+ *
+ * The Amiga epoch, 1 January 1978, was a Sunday.
+ * Returns 0=Sunday, 1=Monday, ... 6=Saturday
+ * ========================================================================= */
 
-    /* Convert from Zeller's 0=Sat to 0=Sun */
-    /* Zeller: 0=Sat, 1=Sun, 2=Mon, ... 6=Fri */
-    /* We want: 0=Sun, 1=Mon, ... 6=Sat */
-    h = ((h + 6) % 7);
+static UBYTE day_of_week(LONG year, UBYTE month, UBYTE day)
+{
+    UWORD dow;
 
-    return (UBYTE)h;
+    divu_w(days_from_civil(year, month, day), 7, &dow);
+    return (UBYTE)dow;
 }
 
 /* =========================================================================
@@ -158,84 +261,59 @@ static UBYTE nth_dow_of_month(LONG year, UBYTE month, UBYTE week, UBYTE dow)
  * Helper: convert Amiga seconds to year/month/day/hour components
  *
  * Amiga epoch: Jan 1, 1978 00:00:00
+ * A day is 675 << 7 seconds, so both divides are DIVU.W: the day count
+ * (at most 49710) and the hour fit a word.
  * ========================================================================= */
 
 static void amiga_secs_to_date(ULONG secs, LONG *year, UBYTE *month,
                                UBYTE *day, UBYTE *hour)
 {
-    ULONG days_remaining;
-    ULONG days_in_year;
-    LONG y;
-    UBYTE m;
-    UBYTE dim;
-
-    /* Extract time of day */
-    days_remaining = secs / SECS_PER_DAY;
-    if (hour)
-        *hour = (UBYTE)((secs % SECS_PER_DAY) / SECS_PER_HOUR);
-
-    /* Count years from 1978 */
-    y = AMIGA_EPOCH_YEAR;
-    for (;;) {
-        days_in_year = is_leap_year(y) ? 366 : 365;
-        if (days_remaining < days_in_year)
-            break;
-        days_remaining -= days_in_year;
-        y++;
-    }
+    UWORD days, rem;
 
-    if (year)
-        *year = y;
-
-    /* Count months */
-    m = 1;
-    for (;;) {
-        dim = get_days_in_month(y, m);
-        if (days_remaining < dim)
-            break;
-        days_remaining -= dim;
-        m++;
-        if (m > 12) {
-            m = 12;  /* Safety check */
-            break;
-        }
-    }
+    days = divu_w(secs >> 7, 675, &rem);
+    if (hour)
+        *hour = (UBYTE)divu_w(((ULONG)rem << 7) | (secs & 127),
+                              SECS_PER_HOUR, NULL);
 
-    if (month)
-        *month = m;
-    if (day)
-        *day = (UBYTE)(days_remaining + 1);  /* Days are 1-based */
+    civil_from_days(days, year, month, day);
 }
 
 /* =========================================================================
- * Helper: convert year/month/day/hour to seconds since Amiga epoch
+ * Helper: convert year/month/day plus minutes to seconds since Amiga epoch
  *
- * Used to calculate DST transition times
+ * Used to calculate DST transition times. The minutes may be negative or
+ * run past midnight, as POSIX TZ rule times can (e.g. "/-1" or "/24").
  * ========================================================================= */
 
-static ULONG date_to_amiga_secs(LONG year, UBYTE month, UBYTE day, UBYTE hour)
+static ULONG date_to_amiga_secs(LONG year, UBYTE month, UBYTE day, WORD mins)
 {
-    ULONG secs = 0;
-    LONG y;
-    UBYTE m;
-
-    /* Count days from years */
-    for (y = AMIGA_EPOCH_YEAR; y < year; y++) {
-        secs += (is_leap_year(y) ? 366 : 365) * SECS_PER_DAY;
-    }
-
-    /* Count days from months */
-    for (m = 1; m < month; m++) {
-        secs += get_days_in_month(year, m) * SECS_PER_DAY;
-    }
+    UWORD days = (UWORD)days_from_civil(year, month, day);
 
-    /* Add days (1-based, so subtract 1) */
-    secs += (day - 1) * SECS_PER_DAY;
+    return (((ULONG)days * 675U) << 7) + (ULONG)((LONG)mins * SECS_PER_MIN);
+}
 
-    /* Add hours */
-    secs += hour * SECS_PER_HOUR;
+/* =========================================================================
+ * Helper: DST start and end of a year, in local standard seconds
+ *
+ * As in a POSIX TZ string, the start time is standard time and the
+ * end time DST.
+ * ========================================================================= */
 
-    return secs;
+static void dst_transitions(const TZEntry *tz, LONG year,
+                            ULONG *start_secs, ULONG *end_secs)
+{
+    UBYTE start_day, end_day;
+
+    start_day = nth_dow_of_month(year, tz->dst_start_month,
+                                 tz->dst_start_week, tz->dst_start_dow);
+    end_day = nth_dow_of_month(year, tz->dst_end_month,
+                               tz->dst_end_week, tz->dst_end_dow);
+
+    *start_secs = date_to_amiga_secs(year, tz->dst_start_month,
+                                     start_day, tz->dst_start_mins);
+    *end_secs = date_to_amiga_secs(year, tz->dst_end_month,
+                                   end_day, tz->dst_end_mins) -
+                (ULONG)tz->dst_offset_mins * SECS_PER_MIN;
 }
 
 /* =========================================================================
@@ -255,116 +333,265 @@ static BOOL str_equal(const char *a, const char *b)
     return (*a == *b);
 }
 
+/* =========================================================================
+ * Helper: name hash for the perfect hash index in tz_table.c
+ *
+ * Must match name_hash() and mix_hash() in scripts/gen_tz_table.py.
+ * Shifts and adds only: no 32-bit multiply on the 68000.
+ * ========================================================================= */
+
+static ULONG name_hash(const char *s)
+{
+    ULONG h = 5381;
+
+    while (*s)
+        h = ((h << 5) + h) ^ (UBYTE)*s++;
+    return h;
+}
+
+static ULONG mix_hash(ULONG h)
+{
+    h = ~h + (h << 15);
+    h ^= h >> 12;
+    h += h << 2;
+    h ^= h >> 4;
+    h += (h << 3) + (h << 11);
+    h ^= h >> 16;
+    return h;
+}
+
 /* =========================================================================
  * tz_find_by_name - Find timezone entry by full IANA name
  *
- * Linear search through tz_table[].
- * Returns pointer to entry or NULL if not found.
+ * One probe of the generated perfect hash and a single string compare
+ * to confirm it. Returns pointer to entry or NULL if not found.
  * ========================================================================= */
 
 const TZEntry *tz_find_by_name(const char *name)
 {
-    ULONG i;
+    const TZEntry *e;
+    ULONG h, slot;
+    LONG d;
 
-    if (!name)
+    if (!name || tz_table_count == 0)
         return NULL;
 
-    for (i = 0; i < tz_table_count; i++) {
-        if (str_equal(tz_table[i].name, name))
-            return &tz_table[i];
-    }
+    h = name_hash(name);
+    d = tz_hash_disp[mix_hash(h) % tz_table_count];
+    if (d < 0)
+        slot = (ULONG)(-d - 1);
+    else
+        slot = mix_hash(h ^ (ULONG)d) % tz_table_count;
 
-    return NULL;
+    e = &tz_table[tz_hash_slot[slot]];
+    return str_equal(e->name, name) ? e : NULL;
 }
 
 /* =========================================================================
- * tz_get_regions - Get list of unique region names
+ * tz_get_regions - Get the list of regions
  *
- * Builds static array of unique regions on first call.
- * Returns array of region strings, sets count via output parameter.
+ * tz_table.c lists them in order, each with its slice of tz_table[].
+ * Returns the array, sets count via output parameter.
  * ========================================================================= */
 
-const char **tz_get_regions(ULONG *count)
+const TZRegion *tz_get_regions(ULONG *count)
 {
-    ULONG i, j;
-    BOOL found;
-
-    if (!regions_initialized) {
-        region_count = 0;
-
-        for (i = 0; i < tz_table_count && region_count < MAX_REGIONS; i++) {
-            /* Check if this region is already in our list */
-            found = FALSE;
-            for (j = 0; j < region_count; j++) {
-                if (str_equal(region_list[j], tz_table[i].region)) {
-                    found = TRUE;
-                    break;
-                }
-            }
-
-            if (!found) {
-                region_list[region_count++] = tz_table[i].region;
-            }
-        }
+    if (count)
+        *count = tz_region_count;
+
+    return tz_regions;
+}
 
-        /* NULL-terminate for GadTools GTCY_Labels */
-        if (region_count < MAX_REGIONS)
-            region_list[region_count] = NULL;
+/* =========================================================================
+ * tz_get_cities - Get the timezone entries of a region
+ *
+ * The table is sorted by region and city, so this is just the
+ * region's slice of tz_table[]. Returns its first entry, sets count
+ * via output parameter.
+ * ========================================================================= */
 
-        regions_initialized = TRUE;
+const TZEntry *tz_get_cities(const TZRegion *region, ULONG *count)
+{
+    if (!region) {
+        if (count)
+            *count = 0;
+        return tz_table;
     }
 
     if (count)
-        *count = region_count;
+        *count = region->count;
 
-    return region_list;
+    return &tz_table[region->first];
 }
 
 /* =========================================================================
- * tz_get_cities_for_region - Get timezone entries for a region
+ * Helper: fill the DST window cache for a UTC time
+ *
+ * The window runs from the latest transition at or before utc_secs to
+ * the earliest one after it, among last, this and next year's (in
+ * local standard seconds, like the rules). Whether DST is on follows
+ * the same test as always:
+ *
+ * Northern hemisphere: DST start month < DST end month
+ * (e.g., March to November in USA), DST is active when
+ * start <= now < end.
+ *
+ * Southern hemisphere: DST start month > DST end month
+ * (e.g., October to April in Australia), DST is active when
+ * now >= start OR now < end, which handles the year wrap.
  *
- * Builds static array of TZEntry pointers for given region.
- * Returns array, sets count via output parameter.
+ * Caller checks that tz has DST and utc_secs is not before the zone's
+ * first local second.
  * ========================================================================= */
 
-const TZEntry **tz_get_cities_for_region(const char *region, ULONG *count)
+static void fill_window(const TZEntry *tz, ULONG utc_secs)
 {
-    ULONG i;
+    LONG year, y;
+    LONG std_secs;
+    ULONG local_secs, start_secs, end_secs;
+    ULONG prev, next;
+    ULONG this_start = 0, this_end = 0;
+
+    std_secs = (LONG)tz->std_offset_mins * SECS_PER_MIN;
+    local_secs = (ULONG)((LONG)utc_secs + std_secs);
+
+    amiga_secs_to_date(local_secs, &year, NULL, NULL, NULL);
+
+    prev = 0;
+    next = 0xFFFFFFFFUL;
+    for (y = year - 1; y <= year + 1; y++) {
+        if (y < AMIGA_EPOCH_YEAR)
+            continue;
+        dst_transitions(tz, y, &start_secs, &end_secs);
+        if (y == year) {
+            this_start = start_secs;
+            this_end = end_secs;
+        }
+        if (start_secs <= local_secs) {
+            if (start_secs > prev)
+                prev = start_secs;
+        } else if (start_secs < next) {
+            next = start_secs;
+        }
+        if (end_secs <= local_secs) {
+            if (end_secs > prev)
+                prev = end_secs;
+        } else if (end_secs < next) {
+            next = end_secs;
+        }
+    }
 
-    /* Check if we already have this region cached */
-    if (cached_region && str_equal(cached_region, region)) {
-        if (count)
-            *count = city_count;
-        return city_list;
+    if (tz->dst_start_month < tz->dst_end_month)
+        win_dst = (local_secs >= this_start && local_secs < this_end);
+    else
+        win_dst = (local_secs >= this_start || local_secs < this_end);
+
+    win_offset = (LONG)tz->std_offset_mins +
+                 (win_dst ? (LONG)tz->dst_offset_mins : 0);
+
+    /* Back to UTC; with no transition on a side, the window is open */
+    win_from = (prev == 0) ? 0 : (ULONG)((LONG)prev - std_secs);
+    win_has_next = (next != 0xFFFFFFFFUL);
+    win_until = win_has_next ? (ULONG)((LONG)next - std_secs) : 0xFFFFFFFFUL;
+    win_tz = tz;
+}
+
+/* =========================================================================
+ * Helper: fill the DST window cache from a zone's exact transitions
+ *
+ * Binary search for the last transition at or before utc_secs; the
+ * zone's first entry is the state at tz_trans_from, so there always
+ * is one. The window ends at the end of the span, where the rules take
+ * over. Caller checks that utc_secs is inside the span.
+ * ========================================================================= */
+
+static void fill_from_table(const TZEntry *tz, ULONG utc_secs)
+{
+    const ULONG *t = &tz_transitions[tz->trans_first];
+    ULONG secs = utc_secs - tz_trans_from;
+    UWORD lo = 0, hi = tz->trans_count, mid;
+
+    while (hi - lo > 1) {
+        mid = (lo + hi) >> 1;
+        if (MINS_TO_SECS(TZ_TRANS_MINS(t[mid])) <= secs)
+            lo = mid;
+        else
+            hi = mid;
     }
 
-    /* Build new city list for this region */
-    city_count = 0;
-    cached_region = region;
+    win_dst = (t[lo] & TZ_TRANS_DST) != 0;
+    win_offset = TZ_TRANS_OFFSET(t[lo]) * 15;
+    win_from = tz_trans_from + MINS_TO_SECS(TZ_TRANS_MINS(t[lo]));
+    win_until = (hi < tz->trans_count)
+        ? tz_trans_from + MINS_TO_SECS(TZ_TRANS_MINS(t[hi]))
+        : tz_trans_until;
+    win_has_next = TRUE;
+    win_tz = tz;
+}
 
-    if (!region) {
-        if (count)
-            *count = 0;
-        return city_list;
+/* =========================================================================
+ * Helper: make the DST window cache cover a UTC time
+ *
+ * Exact transitions where the zone has them, the rules elsewhere.
+ * Returns FALSE if neither applies (no DST), or utc_secs is too early
+ * to calculate it.
+ * ========================================================================= */
+
+static BOOL dst_window(const TZEntry *tz, ULONG utc_secs)
+{
+    if (!tz)
+        return FALSE;
+
+    if (tz == win_tz && utc_secs >= win_from && utc_secs < win_until)
+        return TRUE;
+
+    if (tz->trans_count > 0 &&
+        utc_secs >= tz_trans_from && utc_secs < tz_trans_until) {
+        fill_from_table(tz, utc_secs);
+        return TRUE;
     }
 
-    for (i = 0; i < tz_table_count && city_count < MAX_CITIES; i++) {
-        if (str_equal(tz_table[i].region, region)) {
-            city_list[city_count++] = &tz_table[i];
-        }
+    /* No DST if dst_start_month is 0 or dst_offset is 0, but standard
+     * time before the span still ends where the span starts */
+    if (tz->dst_start_month == 0 || tz->dst_offset_mins == 0) {
+        if (tz->trans_count == 0 || utc_secs >= tz_trans_from)
+            return FALSE;
+        win_dst = FALSE;
+        win_offset = (LONG)tz->std_offset_mins;
+        win_from = 0;
+        win_until = tz_trans_from;
+        win_has_next = TRUE;
+        win_tz = tz;
+        return TRUE;
     }
 
-    if (count)
-        *count = city_count;
+    /* Local standard time must not fall before the Amiga epoch */
+    if (tz->std_offset_mins < 0 &&
+        utc_secs < (ULONG)((-tz->std_offset_mins) * SECS_PER_MIN))
+        return FALSE;
 
-    return city_list;
+    fill_window(tz, utc_secs);
+
+    /* The rules' window must not reach into the exact span */
+    if (tz->trans_count > 0) {
+        if (utc_secs >= tz_trans_until && win_from < tz_trans_until)
+            win_from = tz_trans_until;
+        if (utc_secs < tz_trans_from && win_until > tz_trans_from) {
+            win_until = tz_trans_from;
+            win_has_next = TRUE;
+        }
+    }
+
+    return TRUE;
 }
 
 /* =========================================================================
  * tz_is_dst_active - Check if DST is active for given UTC time
  *
  * Handles both northern hemisphere (DST spring-fall) and southern
- * hemisphere (DST fall-spring wrapping year).
+ * hemisphere (DST fall-spring wrapping year), or looks it up in the
+ * zone's exact transitions. Answered from the DST window cache until
+ * the next transition.
  *
  * utc_secs is Amiga epoch seconds (since Jan 1, 1978).
  * Returns TRUE if DST is currently active, FALSE otherwise.
@@ -372,66 +599,63 @@ const TZEntry **tz_get_cities_for_region(const char *region, ULONG *count)
 
 BOOL tz_is_dst_active(const TZEntry *tz, ULONG utc_secs)
 {
-    LONG year;
-    UBYTE month, day, hour;
-    ULONG local_secs;
-    UBYTE dst_start_day, dst_end_day;
-    ULONG dst_start_secs, dst_end_secs;
-
-    if (!tz)
+    if (!dst_window(tz, utc_secs))
         return FALSE;
 
-    /* No DST if dst_start_month is 0 or dst_offset is 0 */
-    if (tz->dst_start_month == 0 || tz->dst_offset_mins == 0)
+    return win_dst;
+}
+
+/* =========================================================================
+ * tz_next_transition - Find the next DST change after a UTC time
+ *
+ * Uses the same rules, transitions and cache as tz_is_dst_active().
+ * The ends of the exact span bound a window too, but only count where
+ * the offset really changes; so does a transition that just renames
+ * the same offset (DST to standard time). utc_secs and *next_utc are
+ * Amiga epoch seconds.
+ * Returns FALSE if the zone has no DST.
+ * ========================================================================= */
+
+/* Window ends passed over looking for a change: both span ends and a
+ * renaming transition next to one */
+#define TZ_MAX_SKIPS 4
+
+BOOL tz_next_transition(const TZEntry *tz, ULONG utc_secs, ULONG *next_utc)
+{
+    LONG offset;
+    ULONG next;
+    UBYTE i;
+
+    if (!next_utc || !dst_window(tz, utc_secs))
         return FALSE;
 
-    /* Convert UTC to local standard time for comparison */
-    /* We add the standard offset (which may be negative for western zones) */
-    if (tz->std_offset_mins >= 0) {
-        local_secs = utc_secs + (ULONG)(tz->std_offset_mins * SECS_PER_MIN);
-    } else {
-        ULONG offset_secs = (ULONG)((-tz->std_offset_mins) * SECS_PER_MIN);
-        if (utc_secs < offset_secs)
-            return FALSE;  /* Time too early to calculate DST */
-        local_secs = utc_secs - offset_secs;
-    }
+    offset = win_offset;
+    for (i = 0; i < TZ_MAX_SKIPS && win_has_next; i++) {
+        next = win_until;
+
+        /* No DST past the span: standard time from there on */
+        if (!dst_window(tz, next)) {
+            if ((LONG)tz->std_offset_mins == offset)
+                return FALSE;
+            *next_utc = next;
+            return TRUE;
+        }
 
-    /* Get current date/time components in local standard time */
-    amiga_secs_to_date(local_secs, &year, &month, &day, &hour);
-
-    /* Calculate DST transition dates for this year */
-    dst_start_day = nth_dow_of_month(year, tz->dst_start_month,
-                                     tz->dst_start_week, tz->dst_start_dow);
-    dst_end_day = nth_dow_of_month(year, tz->dst_end_month,
-                                   tz->dst_end_week, tz->dst_end_dow);
-
-    /* Calculate transition times in local standard seconds since epoch */
-    dst_start_secs = date_to_amiga_secs(year, tz->dst_start_month,
-                                        dst_start_day, tz->dst_start_hour);
-    dst_end_secs = date_to_amiga_secs(year, tz->dst_end_month,
-                                      dst_end_day, tz->dst_end_hour);
-
-    /* Northern hemisphere: DST start month < DST end month
-     * (e.g., March to November in USA)
-     * DST is active when: start <= now < end
-     */
-    if (tz->dst_start_month < tz->dst_end_month) {
-        return (local_secs >= dst_start_secs && local_secs < dst_end_secs);
+        if (win_offset != offset) {
+            *next_utc = next;
+            return TRUE;
+        }
     }
 
-    /* Southern hemisphere: DST start month > DST end month
-     * (e.g., October to April in Australia)
-     * DST is active when: now >= start OR now < end
-     * This handles the year wrap (DST spans Dec 31/Jan 1)
-     */
-    return (local_secs >= dst_start_secs || local_secs < dst_end_secs);
+    return FALSE;
 }
 
 /* =========================================================================
  * tz_get_offset_mins - Get current offset from UTC in minutes
  *
- * Returns std_offset_mins + dst_offset_mins if DST active,
- * otherwise returns std_offset_mins.
+ * From the exact transitions where the zone has them, otherwise
+ * std_offset_mins + dst_offset_mins if DST active, else
+ * std_offset_mins.
  * ========================================================================= */
 
 LONG tz_get_offset_mins(const TZEntry *tz, ULONG utc_secs)
@@ -439,8 +663,8 @@ LONG tz_get_offset_mins(const TZEntry *tz, ULONG utc_secs)
     if (!tz)
         return 0;
 
-    if (tz_is_dst_active(tz, utc_secs))
-        return (LONG)tz->std_offset_mins + (LONG)tz->dst_offset_mins;
+    if (dst_window(tz, utc_secs))
+        return win_offset;
 
     return (LONG)tz->std_offset_mins;
 }
@@ -475,6 +699,29 @@ static char *append_num(char *p, LONG num)
     return p;
 }
 
+/* =========================================================================
+ * Helper: append a rule time as POSIX extended hours ("-1", "24", "2:45")
+ * ========================================================================= */
+
+static char *append_rule_time(char *p, WORD mins)
+{
+    LONG abs_mins = mins;
+
+    if (abs_mins < 0) {
+        *p++ = '-';
+        abs_mins = -abs_mins;
+    }
+
+    p = append_num(p, abs_mins / 60);
+    if (abs_mins % 60) {
+        *p++ = ':';
+        if (abs_mins % 60 < 10) *p++ = '0';
+        p = append_num(p, abs_mins % 60);
+    }
+
+    return p;
+}
+
 /* =========================================================================
  * tz_set_env - Set TZ and TZONE environment variables
  *
@@ -549,9 +796,9 @@ BOOL tz_set_env(const TZEntry *tz)
         p = append_num(p, tz->dst_start_dow);
 
         /* DST start time if not 2:00 AM */
-        if (tz->dst_start_hour != 2) {
+        if (tz->dst_start_mins != 2 * 60) {
             *p++ = '/';
-            p = append_num(p, tz->dst_start_hour);
+            p = append_rule_time(p, tz->dst_start_mins);
         }
 
         /* DST end rule */
@@ -564,9 +811,9 @@ BOOL tz_set_env(const TZEntry *tz)
         p = append_num(p, tz->dst_end_dow);
 
         /* DST end time if not 2:00 AM */
-        if (tz->dst_end_hour != 2) {
+        if (tz->dst_end_mins != 2 * 60) {
             *p++ = '/';
-            p = append_num(p, tz->dst_end_hour);
+            p = append_rule_time(p, tz->dst_end_mins);
         }
     }
 
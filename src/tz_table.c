@@ -0,0 +1,609 @@
+/* tz_table.c - Generated timezone table from IANA tzdb */
+/* DO NOT EDIT - Generated by scripts/gen_tz_table.py */
+
+#include "synctime.h"
+
+const TZEntry tz_table[] = {
+    {"Africa/Abidjan", "Africa", "Abidjan", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Accra", "Africa", "Accra", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Addis_Ababa", "Africa", "Addis_Ababa", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Algiers", "Africa", "Algiers", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Asmara", "Africa", "Asmara", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Bamako", "Africa", "Bamako", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Bangui", "Africa", "Bangui", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Banjul", "Africa", "Banjul", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Bissau", "Africa", "Bissau", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Blantyre", "Africa", "Blantyre", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Brazzaville", "Africa", "Brazzaville", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Bujumbura", "Africa", "Bujumbura", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Cairo", "Africa", "Cairo", 120, 60, 4, 5, 5, 10, 5, 4, 0, 1440, 0, 0},
+    {"Africa/Casablanca", "Africa", "Casablanca", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 65},
+    {"Africa/Ceuta", "Africa", "Ceuta", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Africa/Conakry", "Africa", "Conakry", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Dakar", "Africa", "Dakar", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Dar_es_Salaam", "Africa", "Dar_es_Salaam", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Djibouti", "Africa", "Djibouti", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Douala", "Africa", "Douala", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/El_Aaiun", "Africa", "El_Aaiun", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 65, 65},
+    {"Africa/Freetown", "Africa", "Freetown", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Gaborone", "Africa", "Gaborone", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Harare", "Africa", "Harare", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Johannesburg", "Africa", "Johannesburg", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Juba", "Africa", "Juba", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Kampala", "Africa", "Kampala", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Khartoum", "Africa", "Khartoum", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Kigali", "Africa", "Kigali", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Kinshasa", "Africa", "Kinshasa", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Lagos", "Africa", "Lagos", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Libreville", "Africa", "Libreville", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Lome", "Africa", "Lome", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Luanda", "Africa", "Luanda", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Lubumbashi", "Africa", "Lubumbashi", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Lusaka", "Africa", "Lusaka", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Malabo", "Africa", "Malabo", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Maputo", "Africa", "Maputo", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Maseru", "Africa", "Maseru", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Mbabane", "Africa", "Mbabane", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Mogadishu", "Africa", "Mogadishu", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Monrovia", "Africa", "Monrovia", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Nairobi", "Africa", "Nairobi", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Ndjamena", "Africa", "Ndjamena", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Niamey", "Africa", "Niamey", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Nouakchott", "Africa", "Nouakchott", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Ouagadougou", "Africa", "Ouagadougou", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Porto-Novo", "Africa", "Porto-Novo", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Sao_Tome", "Africa", "Sao_Tome", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Tripoli", "Africa", "Tripoli", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Tunis", "Africa", "Tunis", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Africa/Windhoek", "Africa", "Windhoek", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Adak", "America", "Adak", -600, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Anchorage", "America", "Anchorage", -540, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Anguilla", "America", "Anguilla", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Antigua", "America", "Antigua", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Araguaina", "America", "Araguaina", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Buenos_Aires", "America", "Argentina/Buenos_Aires", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Catamarca", "America", "Argentina/Catamarca", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Cordoba", "America", "Argentina/Cordoba", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Jujuy", "America", "Argentina/Jujuy", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/La_Rioja", "America", "Argentina/La_Rioja", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Mendoza", "America", "Argentina/Mendoza", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Rio_Gallegos", "America", "Argentina/Rio_Gallegos", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Salta", "America", "Argentina/Salta", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/San_Juan", "America", "Argentina/San_Juan", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/San_Luis", "America", "Argentina/San_Luis", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Tucuman", "America", "Argentina/Tucuman", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Argentina/Ushuaia", "America", "Argentina/Ushuaia", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Aruba", "America", "Aruba", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Asuncion", "America", "Asuncion", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Atikokan", "America", "Atikokan", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Bahia", "America", "Bahia", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Bahia_Banderas", "America", "Bahia_Banderas", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Barbados", "America", "Barbados", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Belem", "America", "Belem", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Belize", "America", "Belize", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Blanc-Sablon", "America", "Blanc-Sablon", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Boa_Vista", "America", "Boa_Vista", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Bogota", "America", "Bogota", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Boise", "America", "Boise", -420, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Cambridge_Bay", "America", "Cambridge_Bay", -420, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Campo_Grande", "America", "Campo_Grande", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Cancun", "America", "Cancun", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Caracas", "America", "Caracas", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Cayenne", "America", "Cayenne", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Cayman", "America", "Cayman", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Chicago", "America", "Chicago", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Chihuahua", "America", "Chihuahua", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Ciudad_Juarez", "America", "Ciudad_Juarez", -420, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Costa_Rica", "America", "Costa_Rica", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Coyhaique", "America", "Coyhaique", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 130, 2},
+    {"America/Creston", "America", "Creston", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Cuiaba", "America", "Cuiaba", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Curacao", "America", "Curacao", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Danmarkshavn", "America", "Danmarkshavn", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Dawson", "America", "Dawson", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Dawson_Creek", "America", "Dawson_Creek", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Denver", "America", "Denver", -420, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Detroit", "America", "Detroit", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Dominica", "America", "Dominica", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Edmonton", "America", "Edmonton", -420, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Eirunepe", "America", "Eirunepe", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/El_Salvador", "America", "El_Salvador", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Fort_Nelson", "America", "Fort_Nelson", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Fortaleza", "America", "Fortaleza", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Glace_Bay", "America", "Glace_Bay", -240, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Goose_Bay", "America", "Goose_Bay", -240, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Grand_Turk", "America", "Grand_Turk", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Grenada", "America", "Grenada", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Guadeloupe", "America", "Guadeloupe", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Guatemala", "America", "Guatemala", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Guayaquil", "America", "Guayaquil", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Guyana", "America", "Guyana", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Halifax", "America", "Halifax", -240, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Havana", "America", "Havana", -300, 60, 3, 2, 0, 11, 1, 0, 0, 60, 0, 0},
+    {"America/Hermosillo", "America", "Hermosillo", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Indiana/Indianapolis", "America", "Indiana/Indianapolis", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Knox", "America", "Indiana/Knox", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Marengo", "America", "Indiana/Marengo", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Petersburg", "America", "Indiana/Petersburg", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Tell_City", "America", "Indiana/Tell_City", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Vevay", "America", "Indiana/Vevay", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Vincennes", "America", "Indiana/Vincennes", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Indiana/Winamac", "America", "Indiana/Winamac", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Inuvik", "America", "Inuvik", -420, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Iqaluit", "America", "Iqaluit", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Jamaica", "America", "Jamaica", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Juneau", "America", "Juneau", -540, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Kentucky/Louisville", "America", "Kentucky/Louisville", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Kentucky/Monticello", "America", "Kentucky/Monticello", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/La_Paz", "America", "La_Paz", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Lima", "America", "Lima", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Los_Angeles", "America", "Los_Angeles", -480, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Maceio", "America", "Maceio", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Managua", "America", "Managua", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Manaus", "America", "Manaus", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Martinique", "America", "Martinique", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Matamoros", "America", "Matamoros", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Mazatlan", "America", "Mazatlan", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Menominee", "America", "Menominee", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Merida", "America", "Merida", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Metlakatla", "America", "Metlakatla", -540, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Mexico_City", "America", "Mexico_City", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Miquelon", "America", "Miquelon", -180, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Moncton", "America", "Moncton", -240, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Monterrey", "America", "Monterrey", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Montevideo", "America", "Montevideo", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Montserrat", "America", "Montserrat", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Nassau", "America", "Nassau", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/New_York", "America", "New_York", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Nome", "America", "Nome", -540, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Noronha", "America", "Noronha", -120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/North_Dakota/Beulah", "America", "North_Dakota/Beulah", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/North_Dakota/Center", "America", "North_Dakota/Center", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/North_Dakota/New_Salem", "America", "North_Dakota/New_Salem", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Nuuk", "America", "Nuuk", -120, 60, 3, 5, 0, 10, 5, 0, -60, 0, 0, 0},
+    {"America/Ojinaga", "America", "Ojinaga", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Panama", "America", "Panama", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Paramaribo", "America", "Paramaribo", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Phoenix", "America", "Phoenix", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Port-au-Prince", "America", "Port-au-Prince", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Port_of_Spain", "America", "Port_of_Spain", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Porto_Velho", "America", "Porto_Velho", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Puerto_Rico", "America", "Puerto_Rico", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Punta_Arenas", "America", "Punta_Arenas", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Rankin_Inlet", "America", "Rankin_Inlet", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Recife", "America", "Recife", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Regina", "America", "Regina", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Resolute", "America", "Resolute", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Rio_Branco", "America", "Rio_Branco", -300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Santarem", "America", "Santarem", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Santiago", "America", "Santiago", -240, 60, 9, 1, 0, 4, 1, 0, 0, 0, 132, 63},
+    {"America/Santo_Domingo", "America", "Santo_Domingo", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Sao_Paulo", "America", "Sao_Paulo", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Scoresbysund", "America", "Scoresbysund", -120, 60, 3, 5, 0, 10, 5, 0, -60, 0, 0, 0},
+    {"America/Sitka", "America", "Sitka", -540, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/St_Johns", "America", "St_Johns", -210, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/St_Kitts", "America", "St_Kitts", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/St_Lucia", "America", "St_Lucia", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/St_Thomas", "America", "St_Thomas", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/St_Vincent", "America", "St_Vincent", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Swift_Current", "America", "Swift_Current", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Tegucigalpa", "America", "Tegucigalpa", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Thule", "America", "Thule", -240, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Tijuana", "America", "Tijuana", -480, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Toronto", "America", "Toronto", -300, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Tortola", "America", "Tortola", -240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Vancouver", "America", "Vancouver", -480, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Whitehorse", "America", "Whitehorse", -420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/Winnipeg", "America", "Winnipeg", -360, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"America/Yakutat", "America", "Yakutat", -540, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"Antarctica/Casey", "Antarctica", "Casey", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/Davis", "Antarctica", "Davis", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/DumontDUrville", "Antarctica", "DumontDUrville", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/Macquarie", "Antarctica", "Macquarie", 600, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Antarctica/Mawson", "Antarctica", "Mawson", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/McMurdo", "Antarctica", "McMurdo", 720, 60, 9, 5, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Antarctica/Palmer", "Antarctica", "Palmer", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/Rothera", "Antarctica", "Rothera", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/Syowa", "Antarctica", "Syowa", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Antarctica/Troll", "Antarctica", "Troll", 0, 120, 3, 5, 0, 10, 5, 0, 60, 180, 0, 0},
+    {"Antarctica/Vostok", "Antarctica", "Vostok", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Aden", "Asia", "Aden", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Almaty", "Asia", "Almaty", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Amman", "Asia", "Amman", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Anadyr", "Asia", "Anadyr", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Aqtau", "Asia", "Aqtau", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Aqtobe", "Asia", "Aqtobe", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Ashgabat", "Asia", "Ashgabat", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Atyrau", "Asia", "Atyrau", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Baghdad", "Asia", "Baghdad", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Bahrain", "Asia", "Bahrain", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Baku", "Asia", "Baku", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Bangkok", "Asia", "Bangkok", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Barnaul", "Asia", "Barnaul", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Beirut", "Asia", "Beirut", 120, 60, 3, 5, 0, 10, 5, 0, 0, 0, 0, 0},
+    {"Asia/Bishkek", "Asia", "Bishkek", 360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Brunei", "Asia", "Brunei", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Chita", "Asia", "Chita", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Colombo", "Asia", "Colombo", 330, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Damascus", "Asia", "Damascus", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Dhaka", "Asia", "Dhaka", 360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Dili", "Asia", "Dili", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Dubai", "Asia", "Dubai", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Dushanbe", "Asia", "Dushanbe", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Famagusta", "Asia", "Famagusta", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Asia/Gaza", "Asia", "Gaza", 120, 60, 5, 2, 0, 10, 1, 0, 120, 120, 195, 93},
+    {"Asia/Hebron", "Asia", "Hebron", 120, 60, 5, 2, 0, 10, 1, 0, 120, 120, 288, 93},
+    {"Asia/Ho_Chi_Minh", "Asia", "Ho_Chi_Minh", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Hong_Kong", "Asia", "Hong_Kong", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Hovd", "Asia", "Hovd", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Irkutsk", "Asia", "Irkutsk", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Jakarta", "Asia", "Jakarta", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Jayapura", "Asia", "Jayapura", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Jerusalem", "Asia", "Jerusalem", 120, 60, 3, 4, 5, 10, 5, 0, 120, 120, 381, 63},
+    {"Asia/Kabul", "Asia", "Kabul", 270, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kamchatka", "Asia", "Kamchatka", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Karachi", "Asia", "Karachi", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kathmandu", "Asia", "Kathmandu", 345, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Khandyga", "Asia", "Khandyga", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kolkata", "Asia", "Kolkata", 330, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Krasnoyarsk", "Asia", "Krasnoyarsk", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kuala_Lumpur", "Asia", "Kuala_Lumpur", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kuching", "Asia", "Kuching", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kuwait", "Asia", "Kuwait", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Macau", "Asia", "Macau", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Magadan", "Asia", "Magadan", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Makassar", "Asia", "Makassar", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Manila", "Asia", "Manila", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Muscat", "Asia", "Muscat", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Nicosia", "Asia", "Nicosia", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Asia/Novokuznetsk", "Asia", "Novokuznetsk", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Novosibirsk", "Asia", "Novosibirsk", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Omsk", "Asia", "Omsk", 360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Oral", "Asia", "Oral", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Phnom_Penh", "Asia", "Phnom_Penh", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Pontianak", "Asia", "Pontianak", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Pyongyang", "Asia", "Pyongyang", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Qatar", "Asia", "Qatar", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Qostanay", "Asia", "Qostanay", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Qyzylorda", "Asia", "Qyzylorda", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Riyadh", "Asia", "Riyadh", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Sakhalin", "Asia", "Sakhalin", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Samarkand", "Asia", "Samarkand", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Seoul", "Asia", "Seoul", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Shanghai", "Asia", "Shanghai", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Singapore", "Asia", "Singapore", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Srednekolymsk", "Asia", "Srednekolymsk", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Taipei", "Asia", "Taipei", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Tashkent", "Asia", "Tashkent", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Tbilisi", "Asia", "Tbilisi", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Tehran", "Asia", "Tehran", 210, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Thimphu", "Asia", "Thimphu", 360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Tokyo", "Asia", "Tokyo", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Tomsk", "Asia", "Tomsk", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Ulaanbaatar", "Asia", "Ulaanbaatar", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Urumqi", "Asia", "Urumqi", 360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Ust-Nera", "Asia", "Ust-Nera", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Vientiane", "Asia", "Vientiane", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Vladivostok", "Asia", "Vladivostok", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Yakutsk", "Asia", "Yakutsk", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Yangon", "Asia", "Yangon", 390, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Yekaterinburg", "Asia", "Yekaterinburg", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Yerevan", "Asia", "Yerevan", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Atlantic/Azores", "Atlantic", "Azores", -60, 60, 3, 5, 0, 10, 5, 0, 0, 60, 0, 0},
+    {"Atlantic/Bermuda", "Atlantic", "Bermuda", -240, 60, 3, 2, 0, 11, 1, 0, 120, 120, 0, 0},
+    {"Atlantic/Canary", "Atlantic", "Canary", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Atlantic/Cape_Verde", "Atlantic", "Cape_Verde", -60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Atlantic/Faroe", "Atlantic", "Faroe", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Atlantic/Madeira", "Atlantic", "Madeira", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Atlantic/Reykjavik", "Atlantic", "Reykjavik", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Atlantic/South_Georgia", "Atlantic", "South_Georgia", -120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Atlantic/St_Helena", "Atlantic", "St_Helena", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Atlantic/Stanley", "Atlantic", "Stanley", -180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Adelaide", "Australia", "Adelaide", 570, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Australia/Brisbane", "Australia", "Brisbane", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Broken_Hill", "Australia", "Broken_Hill", 570, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Australia/Darwin", "Australia", "Darwin", 570, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Eucla", "Australia", "Eucla", 525, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Hobart", "Australia", "Hobart", 600, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Australia/Lindeman", "Australia", "Lindeman", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Lord_Howe", "Australia", "Lord_Howe", 630, 30, 10, 1, 0, 4, 1, 0, 120, 120, 0, 0},
+    {"Australia/Melbourne", "Australia", "Melbourne", 600, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Australia/Perth", "Australia", "Perth", 480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Sydney", "Australia", "Sydney", 600, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Europe/Amsterdam", "Europe", "Amsterdam", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Andorra", "Europe", "Andorra", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Astrakhan", "Europe", "Astrakhan", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Athens", "Europe", "Athens", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Belgrade", "Europe", "Belgrade", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Berlin", "Europe", "Berlin", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Brussels", "Europe", "Brussels", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Bucharest", "Europe", "Bucharest", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Budapest", "Europe", "Budapest", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Chisinau", "Europe", "Chisinau", 120, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Copenhagen", "Europe", "Copenhagen", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Dublin", "Europe", "Dublin", 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 444, 63},
+    {"Europe/Gibraltar", "Europe", "Gibraltar", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Guernsey", "Europe", "Guernsey", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Europe/Helsinki", "Europe", "Helsinki", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Isle_of_Man", "Europe", "Isle_of_Man", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Europe/Istanbul", "Europe", "Istanbul", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Jersey", "Europe", "Jersey", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Europe/Kaliningrad", "Europe", "Kaliningrad", 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Kirov", "Europe", "Kirov", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Kyiv", "Europe", "Kyiv", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Lisbon", "Europe", "Lisbon", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Europe/Ljubljana", "Europe", "Ljubljana", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/London", "Europe", "London", 0, 60, 3, 5, 0, 10, 5, 0, 60, 120, 0, 0},
+    {"Europe/Luxembourg", "Europe", "Luxembourg", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Madrid", "Europe", "Madrid", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Malta", "Europe", "Malta", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Minsk", "Europe", "Minsk", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Monaco", "Europe", "Monaco", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Moscow", "Europe", "Moscow", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Oslo", "Europe", "Oslo", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Paris", "Europe", "Paris", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Prague", "Europe", "Prague", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Riga", "Europe", "Riga", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Rome", "Europe", "Rome", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Samara", "Europe", "Samara", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Sarajevo", "Europe", "Sarajevo", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Saratov", "Europe", "Saratov", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Simferopol", "Europe", "Simferopol", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Skopje", "Europe", "Skopje", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Sofia", "Europe", "Sofia", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Stockholm", "Europe", "Stockholm", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Tallinn", "Europe", "Tallinn", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Tirane", "Europe", "Tirane", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Ulyanovsk", "Europe", "Ulyanovsk", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Vaduz", "Europe", "Vaduz", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Vienna", "Europe", "Vienna", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Vilnius", "Europe", "Vilnius", 120, 60, 3, 5, 0, 10, 5, 0, 180, 240, 0, 0},
+    {"Europe/Volgograd", "Europe", "Volgograd", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Warsaw", "Europe", "Warsaw", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Zagreb", "Europe", "Zagreb", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Europe/Zurich", "Europe", "Zurich", 60, 60, 3, 5, 0, 10, 5, 0, 120, 180, 0, 0},
+    {"Indian/Antananarivo", "Indian", "Antananarivo", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Chagos", "Indian", "Chagos", 360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Christmas", "Indian", "Christmas", 420, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Cocos", "Indian", "Cocos", 390, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Comoro", "Indian", "Comoro", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Kerguelen", "Indian", "Kerguelen", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Mahe", "Indian", "Mahe", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Maldives", "Indian", "Maldives", 300, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Mauritius", "Indian", "Mauritius", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Mayotte", "Indian", "Mayotte", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Indian/Reunion", "Indian", "Reunion", 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Apia", "Pacific", "Apia", 780, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Auckland", "Pacific", "Auckland", 720, 60, 9, 5, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Pacific/Bougainville", "Pacific", "Bougainville", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Chatham", "Pacific", "Chatham", 765, 60, 9, 5, 0, 4, 1, 0, 165, 225, 0, 0},
+    {"Pacific/Chuuk", "Pacific", "Chuuk", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Easter", "Pacific", "Easter", -360, 60, 9, 1, 0, 4, 1, 0, -120, -120, 507, 63},
+    {"Pacific/Efate", "Pacific", "Efate", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Fakaofo", "Pacific", "Fakaofo", 780, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Fiji", "Pacific", "Fiji", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Funafuti", "Pacific", "Funafuti", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Galapagos", "Pacific", "Galapagos", -360, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Gambier", "Pacific", "Gambier", -540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Guadalcanal", "Pacific", "Guadalcanal", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Guam", "Pacific", "Guam", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Honolulu", "Pacific", "Honolulu", -600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Kanton", "Pacific", "Kanton", 780, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Kiritimati", "Pacific", "Kiritimati", 840, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Kosrae", "Pacific", "Kosrae", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Kwajalein", "Pacific", "Kwajalein", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Majuro", "Pacific", "Majuro", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Marquesas", "Pacific", "Marquesas", -570, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Midway", "Pacific", "Midway", -660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Nauru", "Pacific", "Nauru", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Niue", "Pacific", "Niue", -660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Norfolk", "Pacific", "Norfolk", 660, 60, 10, 1, 0, 4, 1, 0, 120, 180, 0, 0},
+    {"Pacific/Noumea", "Pacific", "Noumea", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Pago_Pago", "Pacific", "Pago_Pago", -660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Palau", "Pacific", "Palau", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Pitcairn", "Pacific", "Pitcairn", -480, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Pohnpei", "Pacific", "Pohnpei", 660, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Port_Moresby", "Pacific", "Port_Moresby", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Rarotonga", "Pacific", "Rarotonga", -600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Saipan", "Pacific", "Saipan", 600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Tahiti", "Pacific", "Tahiti", -600, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Tarawa", "Pacific", "Tarawa", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Tongatapu", "Pacific", "Tongatapu", 780, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Wake", "Pacific", "Wake", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Pacific/Wallis", "Pacific", "Wallis", 720, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+};
+
+const ULONG tz_table_count = 407;
+
+const TZRegion tz_regions[] = {
+    {"Africa", 0, 52},
+    {"America", 52, 140},
+    {"Antarctica", 192, 11},
+    {"Asia", 203, 82},
+    {"Atlantic", 285, 10},
+    {"Australia", 295, 11},
+    {"Europe", 306, 52},
+    {"Indian", 358, 11},
+    {"Pacific", 369, 38},
+};
+
+const ULONG tz_region_count = 9;
+
+/* Perfect hash over the names: displacement per bucket */
+const WORD tz_hash_disp[] = {
+    3, 1, 0, -403, 0, 1, 0, 0, 0, 1, -402, -401,
+    2, 1, -398, -397, -393, 0, -389, -385, 5, 0, 0, -384,
+    0, 1, -381, 0, 1, -378, 1, 0, -377, -371, 1, 2,
+    0, 0, -367, 2, 1, -366, 0, 1, 0, 0, -363, 0,
+    1, 0, 1, -360, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, -358, -355, 1, -354, -347, -345, 1, 6, -339, 1, -338,
+    0, -332, 0, 0, 0, 0, 1, 0, 0, 0, -329, 1,
+    0, -323, 0, -322, 0, 0, -320, 0, 0, 1, -318, -312,
+    -303, 1, 1, 0, -302, 0, -298, -290, 0, 0, 0, 0,
+    0, -284, 0, -279, -277, 0, 1, 0, -274, 0, -272, 1,
+    -268, -265, 2, -263, 1, -258, 0, 2, 1, -257, 3, 0,
+    0, -255, 0, 0, -254, 0, -252, 2, 0, -251, -247, 1,
+    2, -246, 1, 0, 0, 0, -242, -241, 1, 1, 0, 2,
+    1, 0, 0, 0, 4, -240, 0, 0, -239, 1, 0, -235,
+    -232, -231, 6, -230, 0, 1, -229, 1, 1, -228, 0, 0,
+    0, -227, -225, 0, 2, 1, 0, -224, -222, -220, -219, 1,
+    2, 1, 2, 5, 0, -216, -214, 0, 2, 0, -213, 7,
+    -212, -211, -208, 4, -206, 0, 2, -205, -195, -193, 10, 0,
+    -191, -187, -186, -184, 1, 1, 0, 0, 2, -183, 0, 0,
+    0, 2, 2, 0, -181, -180, 2, 2, 0, 0, 4, -178,
+    0, -173, -169, 0, -168, 0, 2, 0, 0, 1, 5, 0,
+    0, 0, -167, 0, -166, 0, -163, 0, 1, -155, 0, 0,
+    0, -152, 0, 0, 0, 0, 0, 0, 0, -151, 0, -149,
+    13, -148, -146, 0, -141, -138, 0, 15, 0, 0, 2, 0,
+    0, -137, 2, -134, 3, 3, 1, -132, 0, 0, 3, 0,
+    2, -131, -127, 4, -120, -118, -115, -114, 1, -108, 0, 1,
+    -107, 0, 0, 0, -106, -99, 0, -97, -93, 2, 13, 0,
+    -89, -88, 5, -87, -85, 0, 0, -83, 0, 7, -80, 6,
+    -79, -72, 2, 1, -70, -69, 1, -67, 2, -66, 0, -65,
+    4, 2, 1, -62, -60, 2, -55, 14, -51, 0, -48, 0,
+    -44, -42, 3, -37, 4, 0, 2, 1, -33, 8, -31, 4,
+    0, 2, -27, -26, 1, 0, -25, -23, -22, 0, -19, 3,
+    0, 0, 0, -16, -15, 0, -13, -12, 0, 0, 0, 0,
+    11, 4, 0, -11, -10, -5, 0, 0, 0, 0, 0,
+};
+
+/* Perfect hash over the names: tz_table[] index per slot */
+const UWORD tz_hash_slot[] = {
+    390, 302, 294, 30, 275, 214, 159, 26, 197, 231, 104, 89,
+    349, 400, 241, 237, 149, 163, 99, 32, 107, 91, 15, 146,
+    16, 48, 287, 296, 376, 50, 167, 185, 166, 121, 160, 336,
+    29, 75, 255, 311, 346, 284, 127, 135, 156, 253, 304, 265,
+    100, 315, 219, 39, 394, 164, 348, 345, 14, 1, 147, 110,
+    251, 281, 233, 280, 380, 113, 383, 134, 131, 25, 43, 117,
+    225, 208, 292, 119, 359, 285, 364, 324, 403, 340, 334, 242,
+    313, 128, 405, 210, 148, 137, 140, 76, 326, 238, 22, 288,
+    236, 96, 86, 375, 187, 161, 200, 190, 398, 229, 367, 273,
+    234, 0, 46, 385, 339, 154, 77, 17, 153, 263, 198, 142,
+    79, 69, 328, 244, 344, 61, 118, 246, 366, 323, 180, 388,
+    223, 55, 183, 188, 393, 256, 8, 125, 90, 406, 31, 309,
+    63, 60, 112, 206, 5, 386, 174, 269, 310, 301, 165, 312,
+    94, 342, 283, 37, 56, 307, 19, 4, 202, 169, 114, 266,
+    151, 252, 97, 374, 150, 341, 181, 93, 40, 103, 270, 305,
+    250, 65, 67, 271, 204, 282, 267, 170, 319, 228, 327, 306,
+    247, 193, 314, 368, 261, 277, 186, 158, 98, 322, 205, 11,
+    38, 351, 18, 108, 177, 157, 395, 143, 179, 378, 401, 293,
+    20, 95, 84, 123, 70, 53, 331, 360, 7, 109, 155, 262,
+    358, 299, 235, 120, 3, 34, 308, 102, 51, 355, 217, 27,
+    57, 391, 352, 402, 126, 389, 397, 245, 45, 74, 259, 88,
+    222, 303, 83, 6, 178, 59, 332, 354, 230, 404, 196, 338,
+    239, 274, 122, 387, 132, 330, 152, 317, 141, 221, 192, 176,
+    194, 232, 240, 105, 258, 343, 171, 72, 130, 321, 392, 111,
+    298, 316, 227, 201, 279, 260, 133, 162, 172, 226, 28, 373,
+    276, 191, 384, 272, 35, 347, 372, 62, 382, 78, 36, 212,
+    333, 66, 24, 353, 115, 257, 68, 139, 58, 357, 337, 369,
+    295, 248, 377, 289, 350, 33, 363, 215, 129, 64, 199, 80,
+    92, 278, 318, 209, 211, 54, 399, 356, 370, 286, 365, 329,
+    300, 220, 81, 73, 49, 249, 124, 144, 371, 290, 136, 195,
+    320, 21, 71, 203, 207, 379, 101, 13, 82, 138, 216, 325,
+    12, 213, 23, 291, 52, 243, 168, 189, 184, 264, 85, 173,
+    268, 145, 9, 396, 2, 224, 254, 116, 87, 47, 381, 42,
+    218, 175, 10, 361, 106, 335, 362, 44, 41, 182, 297,
+};
+
+/* Exact transitions 2025-2055: DST, offset, minutes */
+const ULONG tz_transitions[] = {
+    0x04000000, 0x80012A98, 0x040216D8, 0x800902B8, 0x0409C798, 0x8010DAD8,
+    0x04119FB8, 0x80188B98, 0x041977D8, 0x802063B8, 0x04212898, 0x80281478,
+    0x042900B8, 0x802FEC98, 0x0430B178, 0x8037C4B8, 0x04388998, 0x803F7578,
+    0x044061B8, 0x80474D98, 0x04481278, 0x804EFE58, 0x044FEA98, 0x8056D678,
+    0x0457C2B8, 0x805EAE98, 0x045F7378, 0x80665F58, 0x04674B98, 0x806E3778,
+    0x046EFC58, 0x80760F98, 0x0476D478, 0x807DC058, 0x047EAC98, 0x80859878,
+    0x04865D58, 0x808D4938, 0x048E3578, 0x80952158, 0x04960D98, 0x809CF978,
+    0x049DBE58, 0x80A4AA38, 0x04A59678, 0x80AC8258, 0x04AD4738, 0x80B45A78,
+    0x04B51F58, 0x80BC0B38, 0x04BCF778, 0x80C3E358, 0x04C4A838, 0x80CB9418,
+    0x04CC8058, 0x80D36C38, 0x04D45878, 0x80DB4458, 0x04DC0938, 0x80E2F518,
+    0x04E3E158, 0x80EACD38, 0x04EB9218, 0x80F2A558, 0x04F36A38, 0x04000000,
+    0x80012A98, 0x040216D8, 0x800902B8, 0x0409C798, 0x8010DAD8, 0x04119FB8,
+    0x80188B98, 0x041977D8, 0x802063B8, 0x04212898, 0x80281478, 0x042900B8,
+    0x802FEC98, 0x0430B178, 0x8037C4B8, 0x04388998, 0x803F7578, 0x044061B8,
+    0x80474D98, 0x04481278, 0x804EFE58, 0x044FEA98, 0x8056D678, 0x0457C2B8,
+    0x805EAE98, 0x045F7378, 0x80665F58, 0x04674B98, 0x806E3778, 0x046EFC58,
+    0x80760F98, 0x0476D478, 0x807DC058, 0x047EAC98, 0x80859878, 0x04865D58,
+    0x808D4938, 0x048E3578, 0x80952158, 0x04960D98, 0x809CF978, 0x049DBE58,
+    0x80A4AA38, 0x04A59678, 0x80AC8258, 0x04AD4738, 0x80B45A78, 0x04B51F58,
+    0x80BC0B38, 0x04BCF778, 0x80C3E358, 0x04C4A838, 0x80CB9418, 0x04CC8058,
+    0x80D36C38, 0x04D45878, 0x80DB4458, 0x04DC0938, 0x80E2F518, 0x04E3E158,
+    0x80EACD38, 0x04EB9218, 0x80F2A558, 0x04F36A38, 0xF4000000, 0x7401B774,
+    0xF4000000, 0x70021714, 0xF4057990, 0x700A1694, 0xF40D7910, 0x70121614,
+    0xF4157890, 0x701A1594, 0xF41D7810, 0x70223C74, 0xF4257790, 0x702A3BF4,
+    0xF42D9E70, 0x70323B74, 0xF4359DF0, 0x703A3AF4, 0xF43D9D70, 0x70423A74,
+    0xF4459CF0, 0x704A39F4, 0xF44D9C70, 0x705260D4, 0xF4559BF0, 0x705A6054,
+    0xF45DC2D0, 0x70625FD4, 0xF465C250, 0x706A5F54, 0xF46DC1D0, 0x70725ED4,
+    0xF475C150, 0x707A85B4, 0xF47DC0D0, 0x70828534, 0xF485E7B0, 0x708A84B4,
+    0xF48DE730, 0x70928434, 0xF495E6B0, 0x709A83B4, 0xF49DE630, 0x70A28334,
+    0xF4A5E5B0, 0x70AAAA14, 0xF4ADE530, 0x70B2A994, 0xF4B60C10, 0x70BAA914,
+    0xF4BE0B90, 0x70C2A894, 0xF4C60B10, 0x70CAA814, 0xF4CE0A90, 0x70D2A794,
+    0xF4D60A10, 0x70DACE74, 0xF4DE30F0, 0x70E2CDF4, 0xF4E63070, 0x70EACD74,
+    0xF4EE2FF0, 0x70F2CCF4, 0xF4F62F70, 0x08000000, 0x8C023820, 0x08068664,
+    0x8C09E8E0, 0x080E85E4, 0x8C11E860, 0x0816ACC4, 0x8C19E7E0, 0x081EAC44,
+    0x8C21E760, 0x0826ABC4, 0x8C2A0E40, 0x082EAB44, 0x8C320DC0, 0x0836AAC4,
+    0x8C3A0D40, 0x083ED1A4, 0x8C420CC0, 0x0846D124, 0x8C4A0C40, 0x084ED0A4,
+    0x8C520BC0, 0x0856D024, 0x8C5A32A0, 0x085EA844, 0x8C623220, 0x08668064,
+    0x8C6A31A0, 0x086E3124, 0x8C723120, 0x08760944, 0x8C7A30A0, 0x087DBA04,
+    0x8C7ECDE0, 0x087EF504, 0x8C825780, 0x08859224, 0x8C867EA0, 0x0886F484,
+    0x8C8A5700, 0x088D6A44, 0x8C8E56C0, 0x088EF404, 0x8C925680, 0x08951B04,
+    0x8C962EE0, 0x0896F384, 0x8C9A5600, 0x089CF324, 0x8C9DDFA0, 0x089F1A64,
+    0x8CA25580, 0x08A4CB44, 0x8CA5B7C0, 0x08A719E4, 0x8CAA5500, 0x08AC7C04,
+    0x8CAD8FE0, 0x08AF1964, 0x8CB27BE0, 0x08B45424, 0x8CB540A0, 0x08B718E4,
+    0x8CBA7B60, 0x08BC04E4, 0x8CBD18C0, 0x08BF1864, 0x8CC27AE0, 0x08C3DD04,
+    0x8CC4C980, 0x08C73F44, 0x8CCA7A60, 0x08CBB524, 0x8CCCA1A0, 0x08CF3EC4,
+    0x8CD279E0, 0x08D365E4, 0x8CD479C0, 0x08D73E44, 0x8CDAA0C0, 0x08DB3E04,
+    0x8CDC2A80, 0x08DF3DC4, 0x8CE2A040, 0x08E2EEC4, 0x8CE402A0, 0x08E73D44,
+    0x8CEA9FC0, 0x08EAC6E4, 0x8CEBDAC0, 0x08EF3CC4, 0x8CF38B80, 0x08F763A4,
+    0x08000000, 0x8C023820, 0x08068664, 0x8C09E8E0, 0x080E85E4, 0x8C11E860,
+    0x0816ACC4, 0x8C19E7E0, 0x081EAC44, 0x8C21E760, 0x0826ABC4, 0x8C2A0E40,
+    0x082EAB44, 0x8C320DC0, 0x0836AAC4, 0x8C3A0D40, 0x083ED1A4, 0x8C420CC0,
+    0x0846D124, 0x8C4A0C40, 0x084ED0A4, 0x8C520BC0, 0x0856D024, 0x8C5A32A0,
+    0x085EA844, 0x8C623220, 0x08668064, 0x8C6A31A0, 0x086E3124, 0x8C723120,
+    0x08760944, 0x8C7A30A0, 0x087DBA04, 0x8C7ECDE0, 0x087EF504, 0x8C825780,
+    0x08859224, 0x8C867EA0, 0x0886F484, 0x8C8A5700, 0x088D6A44, 0x8C8E56C0,
+    0x088EF404, 0x8C925680, 0x08951B04, 0x8C962EE0, 0x0896F384, 0x8C9A5600,
+    0x089CF324, 0x8C9DDFA0, 0x089F1A64, 0x8CA25580, 0x08A4CB44, 0x8CA5B7C0,
+    0x08A719E4, 0x8CAA5500, 0x08AC7C04, 0x8CAD8FE0, 0x08AF1964, 0x8CB27BE0,
+    0x08B45424, 0x8CB540A0, 0x08B718E4, 0x8CBA7B60, 0x08BC04E4, 0x8CBD18C0,
+    0x08BF1864, 0x8CC27AE0, 0x08C3DD04, 0x8CC4C980, 0x08C73F44, 0x8CCA7A60,
+    0x08CBB524, 0x8CCCA1A0, 0x08CF3EC4, 0x8CD279E0, 0x08D365E4, 0x8CD479C0,
+    0x08D73E44, 0x8CDAA0C0, 0x08DB3E04, 0x8CDC2A80, 0x08DF3DC4, 0x8CE2A040,
+    0x08E2EEC4, 0x8CE402A0, 0x08E73D44, 0x8CEA9FC0, 0x08EAC6E4, 0x8CEBDAC0,
+    0x08EF3CC4, 0x8CF38B80, 0x08F763A4, 0x08000000, 0x8C01E3C0, 0x08068C04,
+    0x8C09E340, 0x080E8B84, 0x8C11E2C0, 0x0816B264, 0x8C19E240, 0x081EB1E4,
+    0x8C21E1C0, 0x0826B164, 0x8C2A08A0, 0x082EB0E4, 0x8C320820, 0x0836B064,
+    0x8C3A07A0, 0x083ED744, 0x8C420720, 0x0846D6C4, 0x8C4A06A0, 0x084ED644,
+    0x8C520620, 0x0856D5C4, 0x8C5A2D00, 0x085ED544, 0x8C622C80, 0x0866D4C4,
+    0x8C6A2C00, 0x086EFBA4, 0x8C722B80, 0x0876FB24, 0x8C7A2B00, 0x087EFAA4,
+    0x8C8251E0, 0x0886FA24, 0x8C8A5160, 0x088EF9A4, 0x8C9250E0, 0x0896F924,
+    0x8C9A5060, 0x089F2004, 0x8CA24FE0, 0x08A71F84, 0x8CAA4F60, 0x08AF1F04,
+    0x8CB27640, 0x08B71E84, 0x8CBA75C0, 0x08BF1E04, 0x8CC27540, 0x08C744E4,
+    0x8CCA74C0, 0x08CF4464, 0x8CD27440, 0x08D743E4, 0x8CDA9B20, 0x08DF4364,
+    0x8CE29AA0, 0x08E742E4, 0x8CEA9A20, 0x08EF4264, 0x8CF299A0, 0x08F76944,
+    0x80000000, 0x0401EF3C, 0x80068C7C, 0x0409EEBC, 0x800E8BFC, 0x0411EE3C,
+    0x8016B2DC, 0x0419EDBC, 0x801EB25C, 0x0421ED3C, 0x8026B1DC, 0x042A141C,
+    0x802EB15C, 0x0432139C, 0x8036B0DC, 0x043A131C, 0x803ED7BC, 0x0442129C,
+    0x8046D73C, 0x044A121C, 0x804ED6BC, 0x0452119C, 0x8056D63C, 0x045A387C,
+    0x805ED5BC, 0x046237FC, 0x8066D53C, 0x046A377C, 0x806EFC1C, 0x047236FC,
+    0x8076FB9C, 0x047A367C, 0x807EFB1C, 0x04825D5C, 0x8086FA9C, 0x048A5CDC,
+    0x808EFA1C, 0x04925C5C, 0x8096F99C, 0x049A5BDC, 0x809F207C, 0x04A25B5C,
+    0x80A71FFC, 0x04AA5ADC, 0x80AF1F7C, 0x04B281BC, 0x80B71EFC, 0x04BA813C,
+    0x80BF1E7C, 0x04C280BC, 0x80C7455C, 0x04CA803C, 0x80CF44DC, 0x04D27FBC,
+    0x80D7445C, 0x04DAA69C, 0x80DF43DC, 0x04E2A61C, 0x80E7435C, 0x04EAA59C,
+    0x80EF42DC, 0x04F2A51C, 0x80F769BC, 0xEC000000, 0x68021714, 0xEC057990,
+    0x680A1694, 0xEC0D7910, 0x68121614, 0xEC157890, 0x681A1594, 0xEC1D7810,
+    0x68223C74, 0xEC257790, 0x682A3BF4, 0xEC2D9E70, 0x68323B74, 0xEC359DF0,
+    0x683A3AF4, 0xEC3D9D70, 0x68423A74, 0xEC459CF0, 0x684A39F4, 0xEC4D9C70,
+    0x685260D4, 0xEC559BF0, 0x685A6054, 0xEC5DC2D0, 0x68625FD4, 0xEC65C250,
+    0x686A5F54, 0xEC6DC1D0, 0x68725ED4, 0xEC75C150, 0x687A85B4, 0xEC7DC0D0,
+    0x68828534, 0xEC85E7B0, 0x688A84B4, 0xEC8DE730, 0x68928434, 0xEC95E6B0,
+    0x689A83B4, 0xEC9DE630, 0x68A28334, 0xECA5E5B0, 0x68AAAA14, 0xECADE530,
+    0x68B2A994, 0xECB60C10, 0x68BAA914, 0xECBE0B90, 0x68C2A894, 0xECC60B10,
+    0x68CAA814, 0xECCE0A90, 0x68D2A794, 0xECD60A10, 0x68DACE74, 0xECDE30F0,
+    0x68E2CDF4, 0xECE63070, 0x68EACD74, 0xECEE2FF0, 0x68F2CCF4, 0xECF62F70,
+};
+
+const ULONG tz_trans_from = 1483228800UL;
+const ULONG tz_trans_until = 2461449600UL;
+
@@ -58,9 +58,6 @@
 #define LOG_LINE_LEN    80
 #define LOG_MAX_ENTRIES (LOG_MAX_BYTES / LOG_LINE_LEN)
 
-/* Maximum regions for chooser */
-#define MAX_REGIONS     20
-
 /* =========================================================================
  * Static module state - Main window
  * ========================================================================= */
@@ -86,7 +83,7 @@ static Object *layout_root   = NULL;
 /* Timezone selection state */
 static ULONG current_region_idx = 0;
 static ULONG current_city_idx = 0;
-static const TZEntry **current_cities = NULL;
+static const TZEntry *current_cities = NULL;  /* Slice of tz_table[] */
 static ULONG current_city_count = 0;
 
 /* =========================================================================
@@ -142,7 +139,7 @@ static void free_listbrowser_list(struct List *list)
 /* Build the region chooser list */
 static void build_region_chooser_list(void)
 {
-    const char **regions;
+    const TZRegion *regions;
     ULONG region_count, i;
     struct Node *node;
 
@@ -154,8 +151,8 @@ static void build_region_chooser_list(void)
     }
 
     regions = tz_get_regions(&region_count);
-    for (i = 0; i < region_count && i < MAX_REGIONS; i++) {
-        node = AllocChooserNode(CNA_Text, (ULONG)regions[i], TAG_DONE);
+    for (i = 0; i < region_count; i++) {
+        node = AllocChooserNode(CNA_Text, (ULONG)regions[i].name, TAG_DONE);
         if (node) {
             AddTail(&region_chooser_list, node);
         }
@@ -163,7 +160,7 @@ static void build_region_chooser_list(void)
 }
 
 /* Build the city listbrowser list for a given region */
-static void build_city_browser_list(const char *region)
+static void build_city_browser_list(const TZRegion *region)
 {
     ULONG i;
     struct Node *node;
@@ -175,11 +172,11 @@ static void build_city_browser_list(const char *region)
         free_listbrowser_list(&city_browser_list);
     }
 
-    current_cities = tz_get_cities_for_region(region, &current_city_count);
+    current_cities = tz_get_cities(region, &current_city_count);
     for (i = 0; i < current_city_count; i++) {
         node = AllocListBrowserNode(1,
             LBNA_Column, 0,
-            LBNCA_Text, (ULONG)current_cities[i]->city,
+            LBNCA_Text, (ULONG)current_cities[i].city,
             TAG_DONE);
         if (node) {
             AddTail(&city_browser_list, node);
@@ -443,7 +440,7 @@ static BOOL log_window_handle_events(void)
 BOOL window_open(struct Screen *screen)
 {
     SyncConfig *cfg;
-    const char **regions;
+    const TZRegion *regions;
     ULONG region_count, i;
     const TZEntry *tz;
     Object *status_group, *settings_group, *timezone_group, *button_row;
@@ -473,25 +470,21 @@ BOOL window_open(struct Screen *screen)
 
     if (tz) {
         /* Find region index */
+        current_region_idx = 0;
         for (i = 0; i < region_count; i++) {
-            if (strcmp(regions[i], tz->region) == 0) {
+            if (strcmp(regions[i].name, tz->region) == 0) {
                 current_region_idx = i;
                 break;
             }
         }
-        /* Build city list and find city index */
-        build_city_browser_list(tz->region);
-        for (i = 0; i < current_city_count; i++) {
-            if (strcmp(current_cities[i]->name, cfg->tz_name) == 0) {
-                current_city_idx = i;
-                break;
-            }
-        }
+        /* Build city list; the city index is tz's place in the slice */
+        build_city_browser_list(&regions[current_region_idx]);
+        current_city_idx = (ULONG)(tz - current_cities);
         format_tz_info(tz);
     } else {
         current_region_idx = 0;
         if (region_count > 0) {
-            build_city_browser_list(regions[0]);
+            build_city_browser_list(&regions[0]);
         }
         current_city_idx = 0;
         format_tz_info(NULL);
@@ -790,7 +783,7 @@ ULONG window_signal(void)
 
 static void handle_region_change(ULONG new_region)
 {
-    const char **regions;
+    const TZRegion *regions;
     ULONG region_count;
 
     regions = tz_get_regions(&region_count);
@@ -805,7 +798,7 @@ static void handle_region_change(ULONG new_region)
         TAG_DONE);
 
     /* Rebuild city list */
-    build_city_browser_list(regions[new_region]);
+    build_city_browser_list(&regions[new_region]);
     current_city_idx = 0;
 
     /* Reattach list */
@@ -816,7 +809,7 @@ static void handle_region_change(ULONG new_region)
 
     /* Update TZ info */
     if (current_city_count > 0) {
-        format_tz_info(current_cities[0]);
+        format_tz_info(&current_cities[0]);
         SetGadgetAttrs((struct Gadget *)gad_tz_info, win, NULL,
             STRINGA_TextVal, (ULONG)tz_info_buf,
             TAG_DONE);
@@ -833,7 +826,7 @@ static void handle_city_change(ULONG new_city)
         return;
 
     current_city_idx = new_city;
-    format_tz_info(current_cities[new_city]);
+    format_tz_info(&current_cities[new_city]);
     SetGadgetAttrs((struct Gadget *)gad_tz_info, win, NULL,
         STRINGA_TextVal, (ULONG)tz_info_buf,
         TAG_DONE);
@@ -860,9 +853,9 @@ static void save_config_from_gadgets(void)
 
     /* Set timezone from current city selection */
     if (current_city_count > 0 && current_city_idx < current_city_count) {
-        config_set_tz_name(current_cities[current_city_idx]->name);
+        config_set_tz_name(current_cities[current_city_idx].name);
         /* Update TZ/TZONE environment variables */
-        tz_set_env(current_cities[current_city_idx]);
+        tz_set_env(&current_cities[current_city_idx]);
     }
 
     config_save();
@@ -0,0 +1,278 @@
+/* exec_host.c - Threaded stand-in for exec messaging on the host
+ *
+ * Just enough of exec for resolver.c: signals, message ports and a
+ * child process, each process a POSIX thread. One lock guards every
+ * port and signal set, as Forbid() would on the Amiga. Forbid() and
+ * Permit() themselves do nothing: the only use, around a child's last
+ * ReplyMsg(), is there to keep its code loaded, which a thread does
+ * not need.
+ */
+
+#include "synctime.h"
+
+#include <dos/dostags.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  changed = PTHREAD_COND_INITIALIZER;
+
+/* The main task; other threads get theirs from CreateNewProcTags() */
+static struct Process main_proc;
+static __thread struct Task *this_task;
+
+struct Task *FindTask(CONST_STRPTR name)
+{
+    (void)name;
+    if (this_task == NULL)
+        this_task = &main_proc.pr_Task;
+    return this_task;
+}
+
+/* --------------------------------------------------------------------------
+ * Signals
+ * -------------------------------------------------------------------------- */
+
+static void signal_locked(struct Task *task, ULONG mask)
+{
+    task->tc_SigRecvd |= mask;
+    pthread_cond_broadcast(&changed);
+}
+
+ULONG Wait(ULONG mask)
+{
+    struct Task *me = FindTask(NULL);
+    ULONG got;
+
+    pthread_mutex_lock(&lock);
+    while ((me->tc_SigRecvd & mask) == 0)
+        pthread_cond_wait(&changed, &lock);
+    got = me->tc_SigRecvd & mask;
+    me->tc_SigRecvd &= ~got;
+    pthread_mutex_unlock(&lock);
+
+    return got;
+}
+
+void Signal(struct Task *task, ULONG mask)
+{
+    pthread_mutex_lock(&lock);
+    signal_locked(task, mask);
+    pthread_mutex_unlock(&lock);
+}
+
+ULONG SetSignal(ULONG new_sigs, ULONG mask)
+{
+    struct Task *me = FindTask(NULL);
+    ULONG old;
+
+    pthread_mutex_lock(&lock);
+    old = me->tc_SigRecvd;
+    me->tc_SigRecvd = (old & ~mask) | (new_sigs & mask);
+    pthread_mutex_unlock(&lock);
+
+    return old;
+}
+
+void Forbid(void)
+{
+}
+
+void Permit(void)
+{
+}
+
+/* --------------------------------------------------------------------------
+ * Memory
+ * -------------------------------------------------------------------------- */
+
+APTR AllocVec(ULONG size, ULONG flags)
+{
+    (void)flags;
+    return calloc(1, size);
+}
+
+void FreeVec(APTR mem)
+{
+    free(mem);
+}
+
+/* --------------------------------------------------------------------------
+ * Message ports
+ * -------------------------------------------------------------------------- */
+
+struct MsgPort *CreateMsgPort(void)
+{
+    struct Task *me = FindTask(NULL);
+    struct MsgPort *port;
+    UBYTE bit;
+
+    port = AllocVec(sizeof(*port), MEMF_CLEAR);
+    if (port == NULL)
+        return NULL;
+
+    /* Signals 16-31 are free for ports, as on the Amiga */
+    pthread_mutex_lock(&lock);
+    for (bit = 16; bit < 32 && (me->tc_SigAlloc & (1UL << bit)); bit++)
+        ;
+    if (bit < 32)
+        me->tc_SigAlloc |= 1UL << bit;
+    pthread_mutex_unlock(&lock);
+
+    if (bit == 32) {
+        FreeVec(port);
+        return NULL;
+    }
+    port->mp_SigBit = bit;
+    port->mp_SigTask = me;
+    return port;
+}
+
+void DeleteMsgPort(struct MsgPort *port)
+{
+    if (port == NULL)
+        return;
+    pthread_mutex_lock(&lock);
+    port->mp_SigTask->tc_SigAlloc &= ~(1UL << port->mp_SigBit);
+    pthread_mutex_unlock(&lock);
+    FreeVec(port);
+}
+
+static void put_msg(struct MsgPort *port, struct Message *msg, UBYTE type)
+{
+    struct List *l = &port->mp_MsgList;
+
+    pthread_mutex_lock(&lock);
+    msg->mn_Node.ln_Type = type;
+    msg->mn_Node.ln_Succ = NULL;
+    if (l->lh_Head == NULL)
+        l->lh_Head = &msg->mn_Node;
+    else
+        l->lh_TailPred->ln_Succ = &msg->mn_Node;
+    l->lh_TailPred = &msg->mn_Node;
+    signal_locked(port->mp_SigTask, 1UL << port->mp_SigBit);
+    pthread_mutex_unlock(&lock);
+}
+
+void PutMsg(struct MsgPort *port, struct Message *msg)
+{
+    put_msg(port, msg, NT_MESSAGE);
+}
+
+struct Message *GetMsg(struct MsgPort *port)
+{
+    struct List *l = &port->mp_MsgList;
+    struct Node *n;
+
+    pthread_mutex_lock(&lock);
+    n = l->lh_Head;
+    if (n != NULL)
+        l->lh_Head = n->ln_Succ;
+    pthread_mutex_unlock(&lock);
+
+    return (struct Message *)n;
+}
+
+void ReplyMsg(struct Message *msg)
+{
+    if (msg->mn_ReplyPort != NULL)
+        put_msg(msg->mn_ReplyPort, msg, NT_REPLYMSG);
+}
+
+struct Message *WaitPort(struct MsgPort *port)
+{
+    struct Node *n;
+
+    pthread_mutex_lock(&lock);
+    while ((n = port->mp_MsgList.lh_Head) == NULL)
+        pthread_cond_wait(&changed, &lock);
+    pthread_mutex_unlock(&lock);
+
+    return (struct Message *)n;
+}
+
+/* --------------------------------------------------------------------------
+ * Processes
+ *
+ * NP_Entry arrives as a ULONG tag, as on the Amiga, so the code must
+ * sit in the low 4 GB: tests that start processes link with -no-pie.
+ * -------------------------------------------------------------------------- */
+
+struct ProcStart {
+    struct Process *proc;
+    void (*entry)(void);
+};
+
+static void *proc_main(void *arg)
+{
+    struct ProcStart start = *(struct ProcStart *)arg;
+
+    FreeVec(arg);
+    this_task = &start.proc->pr_Task;
+    start.entry();
+    return NULL;
+}
+
+struct Process *CreateNewProcTags(ULONG tag, ...)
+{
+    struct ProcStart *start;
+    struct Process *proc;
+    pthread_t thread;
+    va_list ap;
+    ULONG entry = 0;
+
+    va_start(ap, tag);
+    while (tag != TAG_DONE) {
+        ULONG data = va_arg(ap, ULONG);
+
+        if (tag == NP_Entry)
+            entry = data;
+        tag = va_arg(ap, ULONG);
+    }
+    va_end(ap);
+
+    if (entry == 0)
+        return NULL;
+
+    /* Never freed: a process outlives its last reply */
+    proc = AllocVec(sizeof(*proc), MEMF_CLEAR);
+    start = AllocVec(sizeof(*start), MEMF_CLEAR);
+    if (proc == NULL || start == NULL) {
+        FreeVec(proc);
+        FreeVec(start);
+        return NULL;
+    }
+    proc->pr_MsgPort.mp_SigBit = 8;     /* SIGB_DOS */
+    proc->pr_MsgPort.mp_SigTask = &proc->pr_Task;
+    proc->pr_Task.tc_SigAlloc = 1UL << 8;
+    start->proc = proc;
+    start->entry = (void (*)(void))(uintptr_t)entry;
+
+    if (pthread_create(&thread, NULL, proc_main, start) != 0) {
+        FreeVec(proc);
+        FreeVec(start);
+        return NULL;
+    }
+    pthread_detach(thread);
+    return proc;
+}
+
+/* --------------------------------------------------------------------------
+ * Libraries: any name opens, to a dummy base
+ * -------------------------------------------------------------------------- */
+
+struct Library *OpenLibrary(CONST_STRPTR name, ULONG version)
+{
+    static char base;
+
+    (void)name;
+    (void)version;
+    return (struct Library *)&base;
+}
+
+void CloseLibrary(struct Library *lib)
+{
+    (void)lib;
+}
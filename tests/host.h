@@ -0,0 +1,108 @@
+/* host.h - Host stand-ins for the Amiga types used by synctime.h
+ *
+ * Lets the portable modules (ntptime.c, tz.c, ...) build and run
+ * under the host compiler for "make check". Only what synctime.h
+ * itself needs is here, plus the exec messaging that exec_host.c
+ * emulates with threads; tests stub any other OS call a module makes.
+ */
+
+#ifndef SYNCTIME_HOST_H
+#define SYNCTIME_HOST_H
+
+#include <stdint.h>
+
+typedef uint8_t     UBYTE;
+typedef int8_t      BYTE;
+typedef uint16_t    UWORD;
+typedef int16_t     WORD;
+typedef uint32_t    ULONG;
+typedef int32_t     LONG;
+typedef int16_t     BOOL;
+typedef void       *APTR;
+typedef char       *STRPTR;
+typedef const char *CONST_STRPTR;
+
+#define TRUE  1
+#define FALSE 0
+
+#define GVF_GLOBAL_ONLY 0x100
+
+#define TAG_DONE         0
+#define MEMF_PUBLIC      (1UL << 0)
+#define MEMF_CLEAR       (1UL << 16)
+#define NT_MESSAGE       5
+#define NT_REPLYMSG      7
+#define SIGBREAKF_CTRL_C (1UL << 12)
+
+struct EClockVal {
+    ULONG ev_hi;
+    ULONG ev_lo;
+};
+
+/* exec lists, messages and processes (exec_host.c) */
+struct Node {
+    struct Node *ln_Succ;
+    struct Node *ln_Pred;
+    UBYTE        ln_Type;
+    BYTE         ln_Pri;
+    char        *ln_Name;
+};
+
+struct List {
+    struct Node *lh_Head;           /* NULL when empty */
+    struct Node *lh_Tail;           /* Unused */
+    struct Node *lh_TailPred;       /* Last node */
+};
+
+struct Message {
+    struct Node     mn_Node;
+    struct MsgPort *mn_ReplyPort;
+    UWORD           mn_Length;
+};
+
+struct MsgPort {
+    struct Node  mp_Node;
+    UBYTE        mp_Flags;
+    UBYTE        mp_SigBit;
+    struct Task *mp_SigTask;
+    struct List  mp_MsgList;
+};
+
+struct Task {
+    struct Node tc_Node;
+    ULONG       tc_SigAlloc;
+    ULONG       tc_SigRecvd;
+};
+
+struct Process {
+    struct Task    pr_Task;
+    struct MsgPort pr_MsgPort;
+};
+
+struct Library;
+struct Device;
+struct Screen;
+struct IntuitionBase;
+struct GfxBase;
+
+LONG SetVar(CONST_STRPTR name, CONST_STRPTR buffer, LONG size, ULONG flags);
+
+struct Task    *FindTask(CONST_STRPTR name);
+ULONG           Wait(ULONG mask);
+void            Signal(struct Task *task, ULONG mask);
+ULONG           SetSignal(ULONG new_sigs, ULONG mask);
+void            Forbid(void);
+void            Permit(void);
+APTR            AllocVec(ULONG size, ULONG flags);
+void            FreeVec(APTR mem);
+struct MsgPort *CreateMsgPort(void);
+void            DeleteMsgPort(struct MsgPort *port);
+void            PutMsg(struct MsgPort *port, struct Message *msg);
+struct Message *GetMsg(struct MsgPort *port);
+void            ReplyMsg(struct Message *msg);
+struct Message *WaitPort(struct MsgPort *port);
+struct Process *CreateNewProcTags(ULONG tag, ...);
+struct Library *OpenLibrary(CONST_STRPTR name, ULONG version);
+void            CloseLibrary(struct Library *lib);
+
+#endif /* SYNCTIME_HOST_H */
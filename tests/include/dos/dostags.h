@@ -0,0 +1,9 @@
+/* Host stand-in for <dos/dostags.h>: the tags exec_host.c handles */
+#ifndef DOS_DOSTAGS_H
+#define DOS_DOSTAGS_H
+
+#define NP_Entry      0x800003F3UL
+#define NP_StackSize  0x800003F4UL
+#define NP_Name       0x800003F5UL
+
+#endif
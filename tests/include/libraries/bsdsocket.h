@@ -0,0 +1,10 @@
+/* Host stand-in for <libraries/bsdsocket.h> */
+#ifndef LIBRARIES_BSDSOCKET_H
+#define LIBRARIES_BSDSOCKET_H
+
+#define SBTB_CODE         1
+#define SBTS_CODE         0x3FFF
+#define SBTM_SETVAL(code) (0x80000000UL | (((code) & SBTS_CODE) << SBTB_CODE) | 1)
+#define SBTC_BREAKMASK    1
+
+#endif
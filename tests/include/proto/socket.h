@@ -0,0 +1,8 @@
+/* Host stand-in for <proto/socket.h>; the host's own gethostbyname()
+ * is replaced by the test */
+#ifndef PROTO_SOCKET_H
+#define PROTO_SOCKET_H
+
+LONG SocketBaseTags(ULONG tag, ...);
+
+#endif
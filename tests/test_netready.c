@@ -0,0 +1,276 @@
+/* test_netready.c - Simulated boot for netready.c
+ *
+ * Replays boots on a virtual clock. A stand-in for bsdsocket.library
+ * and the interface probe takes the place of network_probe(): the
+ * stack puts its library in memory at lib_ms, an address is
+ * configured from if_ms on, and the NTP servers answer from ntp_ms
+ * on. The startup logic of
+ * main.c's sync_due() runs on top, once with ready_check() and once as
+ * the old 1-second spin. Each boot reports the time from the network
+ * working to the first sync, the sync attempts that failed, and how
+ * often the library open was tried.
+ *
+ * Includes netready.c itself to reset its state between boots.
+ */
+
+#include "../src/netready.c"
+
+#include <stdio.h>
+
+/* How long a sync takes: answered, or waiting out REPLY_TIMEOUT_MS */
+#define SYNC_OK_MS     100
+#define SYNC_FAIL_MS   5000
+
+/* Boots per scenario, each from a different clock and so a different
+ * (but reproducible) jitter seed, simulated for up to an hour */
+#define BOOTS          50
+#define RUN_MS         3600000UL
+
+#define NEVER          0xFFFFFFFFUL
+
+static ULONG failures;
+static ULONG checks;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond) && failures++ < 10) {                   \
+            printf("%s:%d: ", __FILE__, __LINE__);          \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    } while (0)
+
+/* =========================================================================
+ * Virtual clock and network
+ * ========================================================================= */
+
+static ULONG sim_ms;            /* Since boot */
+static ULONG sim_base;          /* UTC seconds at boot */
+static ULONG lib_ms, if_ms, ntp_ms;
+static ULONG lib_opens;         /* Failed OpenLibrary() searches of LIBS: */
+static ULONG log_lines;
+
+BOOL clock_get_utc(ULONG *utc_secs, ULONG *utc_micro)
+{
+    *utc_secs = sim_base + sim_ms / 1000;
+    *utc_micro = (sim_ms % 1000) * 1000;
+    return TRUE;
+}
+
+void window_log(const char *message)
+{
+    (void)message;
+    log_lines++;
+}
+
+/* A fixed task address, so that ready_init() seeds the jitter from
+ * the virtual clock alone and every run is the same */
+struct Task *FindTask(CONST_STRPTR name)
+{
+    (void)name;
+    return (struct Task *)0x00C01000UL;
+}
+
+LONG network_probe(ULONG *signature, BOOL load)
+{
+    *signature = 0;
+    if (sim_ms < lib_ms) {
+        if (load)
+            lib_opens++;
+        return NET_NO_LIBRARY;
+    }
+    if (sim_ms < if_ms)
+        return NET_NO_INTERFACE;
+    *signature = 0xC0A80002UL;
+    return NET_UP;
+}
+
+/* =========================================================================
+ * Boot
+ * ========================================================================= */
+
+typedef struct {
+    const char *name;
+    ULONG lib_ms, if_ms, ntp_ms;
+} Scenario;
+
+typedef struct {
+    BOOL  synced;
+    ULONG first_ms;             /* Network working to first sync */
+    ULONG failed;               /* Sync attempts that failed */
+    ULONG lib_opens;
+    ULONG log_lines;
+} BootResult;
+
+/* Follows sync_due() and the re-arm after each sync in event_loop():
+ * the outcome is reported when the sync ends, and the next check is
+ * STARTUP_RETRY_INTERVAL after the previous one was due, or that long
+ * after the sync ended if it overran. The network
+ * times move by up to a second from boot to boot, against the
+ * 1-second ticks. */
+static void boot(const Scenario *sc, BOOL spin, ULONG seed, BootResult *r)
+{
+    ULONG due = STARTUP_RETRY_INTERVAL * 1000, delay_ms, end;
+    ULONG shift = (seed * 397) % 1000;
+    BOOL ok = FALSE, quiet;
+
+    net_state = -1;
+    net_sig = 0;
+    lib_delay = 0;
+    ntp_delay = 0;
+    sim_ms = 0;
+    sim_base = 0x40000000UL + seed * 7919;
+    lib_ms = (sc->lib_ms == NEVER) ? NEVER : sc->lib_ms + shift;
+    if_ms = (sc->if_ms == NEVER) ? NEVER : sc->if_ms + shift;
+    ntp_ms = (sc->ntp_ms == NEVER) ? NEVER : sc->ntp_ms + shift;
+    lib_opens = 0;
+    log_lines = 0;
+    r->failed = 0;
+    ready_init();
+
+    while (!ok && due < RUN_MS) {
+        sim_ms = due;
+        if (!spin && !ready_check(&delay_ms)) {
+            due = sim_ms + delay_ms;
+            continue;
+        }
+
+        /* The old spin opened the library as part of every sync */
+        if (spin && sim_ms < lib_ms)
+            lib_opens++;
+
+        quiet = !spin && ready_quiet();
+        ok = (sim_ms >= ntp_ms);
+        if (ok)
+            end = sim_ms + SYNC_OK_MS;
+        else
+            end = sim_ms + (sim_ms >= if_ms ? SYNC_FAIL_MS : 0);
+        sim_ms = end;
+        if (!spin)
+            ready_report(ok);
+        if (!ok) {
+            r->failed++;
+            if (!quiet)
+                log_lines++;    /* A failed sync logs its error */
+        }
+
+        due += STARTUP_RETRY_INTERVAL * 1000;
+        if (due < end)
+            due = end + STARTUP_RETRY_INTERVAL * 1000;
+    }
+
+    r->synced = ok;
+    r->first_ms = ok ? sim_ms - ntp_ms : 0;
+    r->lib_opens = lib_opens;
+    r->log_lines = log_lines;
+}
+
+/* Runs BOOTS boots and keeps the worst of each measure */
+static void run(const Scenario *sc, BOOL spin, BootResult *worst)
+{
+    BootResult r;
+    ULONG i;
+
+    worst->synced = TRUE;
+    worst->first_ms = worst->failed = worst->lib_opens = 0;
+    worst->log_lines = 0;
+    for (i = 0; i < BOOTS; i++) {
+        boot(sc, spin, i, &r);
+        if (!r.synced) worst->synced = FALSE;
+        if (r.first_ms > worst->first_ms) worst->first_ms = r.first_ms;
+        if (r.failed > worst->failed) worst->failed = r.failed;
+        if (r.lib_opens > worst->lib_opens) worst->lib_opens = r.lib_opens;
+        if (r.log_lines > worst->log_lines) worst->log_lines = r.log_lines;
+    }
+}
+
+static void report(const char *what, const BootResult *r)
+{
+    if (r->synced)
+        printf("  %-5s first sync +%5lu ms,", what,
+               (unsigned long)r->first_ms);
+    else
+        printf("  %-5s no sync in an hour,   ", what);
+    printf(" %4lu failed syncs, %4lu library opens, %4lu log lines\n",
+           (unsigned long)r->failed, (unsigned long)r->lib_opens,
+           (unsigned long)r->log_lines);
+}
+
+int main(void)
+{
+    static const Scenario scenarios[] = {
+        /* Stack running, DHCP answers after 20 s */
+        { "DHCP after 20 s",                    0, 20000,  20000 },
+        /* Stack started from a script 30 s in, address 5 s later */
+        { "stack at 30 s, address at 35 s", 30000, 35000,  35000 },
+        /* Address at 2 s, NTP blocked (no route) for 2 minutes */
+        { "NTP unreachable for 2 min",          0,  2000, 120000 },
+        /* Address at 2 s, NTP blocked all along */
+        { "NTP unreachable",                    0,  2000,  NEVER },
+        /* Never any network this hour */
+        { "no network",                     NEVER, NEVER,  NEVER }
+    };
+    BootResult now, old;
+    ULONG i;
+
+    printf("Worst of %d simulated boots:\n", BOOTS);
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        const Scenario *sc = &scenarios[i];
+
+        run(sc, FALSE, &now);
+        run(sc, TRUE, &old);
+        printf("%s\n", sc->name);
+        report("ready", &now);
+        report("spin", &old);
+
+        CHECK(now.failed <= old.failed, "%s: more failed syncs", sc->name);
+        CHECK(now.lib_opens <= old.lib_opens, "%s: more library opens",
+              sc->name);
+
+        /* A sync follows the network coming up within a probe tick,
+         * however late the stack itself was started */
+        if (sc->if_ms != NEVER && sc->if_ms == sc->ntp_ms) {
+            CHECK(now.first_ms <= READY_PROBE_MS + SYNC_OK_MS,
+                  "%s: first sync %lu ms after the network",
+                  sc->name, (unsigned long)now.first_ms);
+            CHECK(now.failed == 0, "%s: %lu failed syncs", sc->name,
+                  (unsigned long)now.failed);
+        }
+
+        /* Servers down: the attempts back off and only the first
+         * failure is logged, yet servers coming back are used after at
+         * most the sync that was timing out and one capped backoff */
+        if (sc->ntp_ms != NEVER && sc->ntp_ms > sc->if_ms) {
+            CHECK(now.first_ms <= SYNC_FAIL_MS + READY_NTP_MAX_MS +
+                                  READY_NTP_MAX_MS / 4 + SYNC_OK_MS,
+                  "%s: first sync %lu ms after the servers",
+                  sc->name, (unsigned long)now.first_ms);
+            CHECK(now.failed * 2 <= old.failed,
+                  "%s: %lu failed syncs", sc->name,
+                  (unsigned long)now.failed);
+            CHECK(now.log_lines <= 4, "%s: %lu log lines", sc->name,
+                  (unsigned long)now.log_lines);
+        }
+
+        /* Servers never answer: a sync about every half minute at most,
+         * and the failure logged once, not once per attempt */
+        if (sc->ntp_ms == NEVER && sc->if_ms != NEVER)
+            CHECK(now.failed <= RUN_MS / (READY_NTP_MAX_MS * 3 / 4) &&
+                  now.log_lines <= 4,
+                  "%s: %lu failed, %lu logged", sc->name,
+                  (unsigned long)now.failed, (unsigned long)now.log_lines);
+
+        /* No network: a few log lines, not one a second */
+        if (sc->lib_ms == NEVER)
+            CHECK(!now.synced && now.failed == 0 && now.log_lines <= 1 &&
+                  now.lib_opens < 100,
+                  "%s: %lu failed, %lu logged, %lu opens", sc->name,
+                  (unsigned long)now.failed, (unsigned long)now.log_lines,
+                  (unsigned long)now.lib_opens);
+    }
+
+    printf("test_netready: %lu checks, %lu failures\n",
+           (unsigned long)checks, (unsigned long)failures);
+    return failures ? 1 : 0;
+}
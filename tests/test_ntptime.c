@@ -0,0 +1,260 @@
+/* test_ntptime.c - Host tests for ntptime.c
+ *
+ * Checks the 32.32 arithmetic, the fraction/microsecond conversions
+ * and sntp_compute_offset() against a 128-bit reference. ntptime.c is built as for
+ * a plain 68000 (no NTP_HAVE_MULU64), so the MULU.W partial products
+ * are what gets tested. Needs a compiler with __int128.
+ */
+
+#include "synctime.h"
+
+#include <stdio.h>
+
+typedef __int128 I128;
+typedef long long I64;
+typedef unsigned long long U64;
+
+static ULONG failures;
+static ULONG checks;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond) && failures++ < 10) {                   \
+            printf("%s:%d: ", __FILE__, __LINE__);          \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    } while (0)
+
+/* xorshift32: same sequence on every host */
+static ULONG rng_state = 2463534242UL;
+
+static ULONG rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* sntp.c's epoch conversions are not tested here; UTC throughout */
+LONG tz_get_offset_mins(const TZEntry *tz, ULONG utc_secs)
+{
+    (void)tz;
+    (void)utc_secs;
+    return 0;
+}
+
+static I64 to64(const NTPTime *t)
+{
+    return (I64)(((U64)(ULONG)t->secs << 32) | t->frac);
+}
+
+static NTPTime from64(I64 v)
+{
+    NTPTime t;
+
+    t.secs = (LONG)(ULONG)((U64)v >> 32);
+    t.frac = (ULONG)v;
+    return t;
+}
+
+/* A random value, biased towards the carry and sign edges */
+static NTPTime random_ntp(void)
+{
+    static const ULONG edge[] = {
+        0, 1, 0x7FFFFFFFUL, 0x80000000UL, 0xFFFFFFFEUL, 0xFFFFFFFFUL
+    };
+    NTPTime t;
+    ULONG r = rng();
+
+    t.secs = (LONG)((r & 3) == 0 ? edge[rng() % 6] : rng());
+    t.frac = (r & 12) == 0 ? edge[rng() % 6] : rng();
+    return t;
+}
+
+static void test_add_sub_half(void)
+{
+    ULONG i;
+
+    for (i = 0; i < 2000000; i++) {
+        NTPTime a = random_ntp(), b = random_ntp(), r, want;
+
+        ntp_add(&r, &a, &b);
+        want = from64((I64)((U64)to64(&a) + (U64)to64(&b)));
+        CHECK(r.secs == want.secs && r.frac == want.frac,
+              "ntp_add %ld.%08lx + %ld.%08lx",
+              (long)a.secs, (unsigned long)a.frac,
+              (long)b.secs, (unsigned long)b.frac);
+
+        ntp_sub(&r, &a, &b);
+        want = from64((I64)((U64)to64(&a) - (U64)to64(&b)));
+        CHECK(r.secs == want.secs && r.frac == want.frac,
+              "ntp_sub %ld.%08lx - %ld.%08lx",
+              (long)a.secs, (unsigned long)a.frac,
+              (long)b.secs, (unsigned long)b.frac);
+
+        /* Rounds toward minus infinity, like an arithmetic shift */
+        ntp_half(&r, &a);
+        want = from64((I64)(((I128)to64(&a) - ((I128)to64(&a) & 1)) / 2));
+        CHECK(r.secs == want.secs && r.frac == want.frac,
+              "ntp_half %ld.%08lx", (long)a.secs, (unsigned long)a.frac);
+    }
+}
+
+static void test_fraction(void)
+{
+    ULONG i, micro, frac;
+
+    /* frac_to_micro: floor(frac * 10^6 / 2^32) */
+    for (i = 0; i < 4000000; i++) {
+        frac = (i < 1000) ? i : (i < 2000) ? 0xFFFFFFFFUL - (i - 1000) : rng();
+        CHECK(ntp_frac_to_micro(frac) == (ULONG)(((U64)frac * 1000000) >> 32),
+              "ntp_frac_to_micro %08lx", (unsigned long)frac);
+    }
+
+    /* micro_to_frac: every microsecond, ceil(micro * 2^32 / 10^6) or
+     * one above (the 2^64 / 10^6 constant is rounded up), and always
+     * back to itself */
+    for (micro = 0; micro < 1000000; micro++) {
+        U64 ceil = (U64)((((I128)micro << 32) + 999999) / 1000000);
+
+        frac = ntp_micro_to_frac(micro);
+        CHECK(frac == ceil || frac == ceil + 1,
+              "ntp_micro_to_frac %lu = %08lx", (unsigned long)micro,
+              (unsigned long)frac);
+        CHECK(ntp_frac_to_micro(frac) == micro,
+              "micro round trip %lu", (unsigned long)micro);
+    }
+}
+
+static void test_micro(void)
+{
+    ULONG i;
+
+    /* to_micro: nearest microsecond (within one), saturating */
+    for (i = 0; i < 2000000; i++) {
+        NTPTime t;
+        I128 want;
+        LONG got;
+
+        t.secs = (LONG)(rng() % 8192) - 4096;
+        t.frac = rng();
+        want = ((I128)to64(&t) * 1000000 + ((I128)1 << 31)) >> 32;
+        if (want > 0x7FFFFFFFL || t.secs >= 2147)
+            want = 0x7FFFFFFFL;
+        else if (t.secs < -2147)
+            want = -0x7FFFFFFFL;
+        got = ntp_to_micro(&t);
+        CHECK(got - want >= -1 && got - want <= 1,
+              "ntp_to_micro %ld.%08lx = %ld, want %lld", (long)t.secs,
+              (unsigned long)t.frac, (long)got, (I64)want);
+    }
+
+    /* from_micro: the magnitude is rounded up by under two fraction
+     * units (see micro_to_frac), and converts back exactly */
+    for (i = 0; i < 2000000; i++) {
+        LONG micro = (LONG)(rng() % 4294000000UL - 2147000000UL);
+        NTPTime t;
+        I128 err;
+
+        if (i < 3)
+            micro = (i == 0) ? 0 : (i == 1) ? 1 : -1;
+        ntp_from_micro(&t, micro);
+        err = (I128)to64(&t) * 1000000 - ((I128)micro << 32);
+        if (micro < 0)
+            err = -err;
+        CHECK(err >= 0 && err < 2000000, "ntp_from_micro %ld",
+              (long)micro);
+        CHECK(ntp_to_micro(&t) == micro, "micro round trip %ld",
+              (long)micro);
+    }
+}
+
+static void test_amiga(void)
+{
+    NTPTime t;
+    ULONG secs, micro;
+
+    ntp_from_amiga(&t, 0, 0);
+    CHECK((ULONG)t.secs == NTP_TO_AMIGA_EPOCH && t.frac == 0,
+          "Amiga epoch");
+
+    ntp_from_amiga(&t, 1234567890UL, 999999);
+    ntp_to_amiga(&t, &secs, &micro);
+    CHECK(secs == 1234567890UL && micro == 999999, "Amiga round trip");
+}
+
+/* One exchange: local clock at t1 (NTP seconds), server ahead by
+ * offset seconds, 20 ms each way and 1 ms in the server */
+static void exchange(SNTPTimestamps *ts, ULONG t1, LONG offset)
+{
+    NTPTime ms;
+
+    ts->t1.secs = (LONG)t1;
+    ts->t1.frac = 0;
+    ntp_from_micro(&ms, 20000);
+    ntp_add(&ts->t2, &ts->t1, &ms);
+    ts->t2.secs += offset;
+    ntp_from_micro(&ms, 1000);
+    ntp_add(&ts->t3, &ts->t2, &ms);
+    ntp_from_micro(&ms, 20000);
+    ntp_add(&ts->t4, &ts->t3, &ms);
+    ts->t4.secs -= offset;
+}
+
+static void test_offset(void)
+{
+    static const LONG big[] = {
+        1515000000L, -1515000000L, 0x7FFFFF00L, -0x7FFFFF00L
+    };
+    SNTPTimestamps ts;
+    SNTPResult res;
+    ULONG i;
+
+    /* Against ((T2 - T1) + (T3 - T4)) / 2 on wrapped differences;
+     * halving each term first may floor one unit lower */
+    for (i = 0; i < 2000000; i++) {
+        I64 a, b, want, got;
+
+        ts.t1 = random_ntp();
+        ts.t2 = random_ntp();
+        ts.t3 = ts.t2;
+        ts.t3.frac += rng() >> 12;
+        ts.t4 = random_ntp();
+        sntp_compute_offset(&ts, &res);
+        a = (I64)((U64)to64(&ts.t2) - (U64)to64(&ts.t1));
+        b = (I64)((U64)to64(&ts.t3) - (U64)to64(&ts.t4));
+        want = (I64)(((I128)a + b - (((I128)a + b) & 1)) / 2);
+        got = to64(&res.offset);
+        CHECK(got == want || got == want - 1,
+              "sntp_compute_offset %lld, want %lld", got, want);
+    }
+
+    /* Local clock at the Amiga epoch (no battery clock), as on a
+     * 1978 boot, and the mirror case */
+    for (i = 0; i < sizeof(big) / sizeof(big[0]); i++) {
+        exchange(&ts, NTP_TO_AMIGA_EPOCH, big[i]);
+        CHECK(sntp_compute_offset(&ts, &res), "offset %ld rejected",
+              (long)big[i]);
+        CHECK(res.offset.secs == big[i] && res.offset.frac == 0,
+              "offset %ld = %ld.%08lx", (long)big[i],
+              (long)res.offset.secs, (unsigned long)res.offset.frac);
+        CHECK(ntp_to_micro(&res.delay) == 40000, "delay at offset %ld",
+              (long)big[i]);
+    }
+}
+
+int main(void)
+{
+    test_add_sub_half();
+    test_fraction();
+    test_micro();
+    test_amiga();
+    test_offset();
+
+    printf("test_ntptime: %lu checks, %lu failures\n",
+           (unsigned long)checks, (unsigned long)failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+/* test_resolver.c - Host tests for resolver.c
+ *
+ * Runs the resolver process on exec_host.c's threads against a fake
+ * gethostbyname() that takes a set time, and checks that the main
+ * task's event loop keeps handling timer ticks while a lookup is in
+ * flight, that cancelling breaks a slow lookup off, and that cleanup
+ * does not wait for one.
+ *
+ * Usage: test_resolver [latency_ms]   (default 500)
+ */
+
+#include "synctime.h"
+
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+/* Tick from the fake timer: every TICK_MS, as a timer.device reply
+ * would wake event_loop() */
+#define TICK_SIG   (1UL << 13)
+#define TICK_MS    10
+
+/* Longest the event loop may go without handling a tick */
+#define MAX_GAP_MS 50
+
+static ULONG failures;
+static ULONG checks;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond) && failures++ < 10) {                   \
+            printf("%s:%d: ", __FILE__, __LINE__);          \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    } while (0)
+
+static ULONG now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ULONG)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void sleep_ms(ULONG ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000;
+    nanosleep(&ts, NULL);
+}
+
+/* =========================================================================
+ * Fake bsdsocket.library
+ * ========================================================================= */
+
+static volatile ULONG fake_latency_ms;
+static volatile ULONG fake_breaks;
+
+LONG SocketBaseTags(ULONG tag, ...)
+{
+    (void)tag;
+    return 0;
+}
+
+/* Takes fake_latency_ms, or less if the caller gets the socket break
+ * signal (SBTC_BREAKMASK), and resolves to 192.0.2.1 and 192.0.2.2 */
+struct hostent *gethostbyname(const char *name)
+{
+    static ULONG addr[2];
+    static char *list[3];
+    static struct hostent h;
+    ULONG start = now_ms(), latency = fake_latency_ms;
+
+    while (now_ms() - start < latency) {
+        if (SetSignal(0, 0) & SIGBREAKF_CTRL_C) {
+            fake_breaks++;
+            return NULL;
+        }
+        sleep_ms(1);
+    }
+
+    addr[0] = 0xC0000201UL;
+    addr[1] = 0xC0000202UL;
+    list[0] = (char *)&addr[0];
+    list[1] = (char *)&addr[1];
+    list[2] = NULL;
+    h.h_name = (char *)name;
+    h.h_addr_list = list;
+    return &h;
+}
+
+/* =========================================================================
+ * Fake timer and event loop
+ * ========================================================================= */
+
+static struct Task *main_task;
+static volatile BOOL ticking;
+
+static void *ticker(void *arg)
+{
+    (void)arg;
+    while (ticking) {
+        sleep_ms(TICK_MS);
+        Signal(main_task, TICK_SIG);
+    }
+    return NULL;
+}
+
+/* One pass of event_loop() for ms: Wait() on the tick and the resolver
+ * reply port. Returns TRUE with the reply for id if one came. */
+static BOOL run_loop(ULONG ms, ULONG want_id, ULONG *addrs, ULONG *count,
+                     ULONG *max_gap, ULONG *ticks)
+{
+    ULONG start = now_ms(), last_tick = start, sigs, id, now;
+
+    *max_gap = 0;
+    *ticks = 0;
+    while ((now = now_ms()) - start < ms) {
+        sigs = Wait(TICK_SIG | resolver_signal());
+        now = now_ms();
+        if (sigs & TICK_SIG) {
+            if (now - last_tick > *max_gap)
+                *max_gap = now - last_tick;
+            last_tick = now;
+            (*ticks)++;
+        }
+        while (resolver_get_reply(&id, addrs, count)) {
+            if (id == want_id)
+                return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* =========================================================================
+ * Tests
+ * ========================================================================= */
+
+static void test_lookup(ULONG latency)
+{
+    ULONG addrs[DNS_MAX_ADDRS], count = 0, gap, ticks, t0, t;
+    BOOL got;
+
+    fake_latency_ms = latency;
+    t0 = now_ms();
+    CHECK(resolver_request(1, "pool.ntp.org"), "resolver_request");
+    t = now_ms() - t0;
+    CHECK(t < MAX_GAP_MS, "resolver_request took %lu ms", (unsigned long)t);
+
+    got = run_loop(latency + 1000, 1, addrs, &count, &gap, &ticks);
+    t = now_ms() - t0;
+    CHECK(got && count == 2 && addrs[0] == 0xC0000201UL &&
+          addrs[1] == 0xC0000202UL, "lookup reply");
+    CHECK(t >= latency, "reply after %lu ms", (unsigned long)t);
+    CHECK(gap < MAX_GAP_MS, "event loop stalled %lu ms", (unsigned long)gap);
+    CHECK(ticks >= latency / TICK_MS / 2, "only %lu ticks in %lu ms",
+          (unsigned long)ticks, (unsigned long)t);
+
+    printf("lookup of %lu ms: reply after %lu ms, %lu ticks handled, "
+           "longest gap %lu ms\n", (unsigned long)latency,
+           (unsigned long)t, (unsigned long)ticks, (unsigned long)gap);
+}
+
+static void test_cancel(void)
+{
+    ULONG addrs[DNS_MAX_ADDRS], count, gap, ticks, breaks, t0, t;
+
+    /* A lookup that would hang for a minute, cancelled after 100 ms */
+    fake_latency_ms = 60000;
+    breaks = fake_breaks;
+    CHECK(resolver_request(2, "hang.example"), "resolver_request");
+    run_loop(100, 2, addrs, &count, &gap, &ticks);
+
+    t0 = now_ms();
+    resolver_cancel();
+    t = now_ms() - t0;
+    CHECK(t < MAX_GAP_MS, "resolver_cancel took %lu ms", (unsigned long)t);
+
+    /* The next lookup is answered at once, not after the minute */
+    fake_latency_ms = 0;
+    CHECK(resolver_request(3, "pool.ntp.org"), "resolver_request");
+    CHECK(run_loop(1000, 3, addrs, &count, &gap, &ticks) && count == 2,
+          "lookup after cancel");
+    t = now_ms() - t0;
+    CHECK(t < 500, "lookup after cancel took %lu ms", (unsigned long)t);
+    CHECK(fake_breaks == breaks + 1, "slow lookup was not broken off");
+    CHECK(gap < MAX_GAP_MS, "event loop stalled %lu ms", (unsigned long)gap);
+
+    printf("cancelled lookup: next reply after %lu ms\n", (unsigned long)t);
+}
+
+static void test_cleanup(void)
+{
+    ULONG t0, t;
+
+    fake_latency_ms = 60000;
+    CHECK(resolver_request(4, "hang.example"), "resolver_request");
+    sleep_ms(50);
+
+    t0 = now_ms();
+    resolver_cleanup();
+    t = now_ms() - t0;
+    CHECK(t < 500, "resolver_cleanup took %lu ms", (unsigned long)t);
+    CHECK(!resolver_available(), "resolver still available");
+
+    printf("cleanup with a lookup in flight: %lu ms\n", (unsigned long)t);
+}
+
+int main(int argc, char **argv)
+{
+    ULONG latency = (argc > 1) ? (ULONG)atol(argv[1]) : 500;
+    pthread_t tick_thread;
+
+    main_task = FindTask(NULL);
+    ticking = TRUE;
+    pthread_create(&tick_thread, NULL, ticker, NULL);
+
+    CHECK(resolver_init(), "resolver_init");
+    if (resolver_available()) {
+        test_lookup(latency);
+        test_cancel();
+        test_cleanup();
+    }
+
+    ticking = FALSE;
+    pthread_join(tick_thread, NULL);
+
+    printf("test_resolver: %lu checks, %lu failures\n",
+           (unsigned long)checks, (unsigned long)failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,478 @@
+/* test_tz.c - Host tests for tz.c
+ *
+ * Includes tz.c itself to reach its static helpers, and links the
+ * generated tz_table.c. Also times tz_find_by_name() against the
+ * linear scan it replaced, and cached offset lookups against rule
+ * evaluation.
+ */
+
+#include "../src/tz.c"
+
+#include <stdio.h>
+#include <time.h>
+
+static ULONG failures;
+static ULONG checks;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond) && failures++ < 10) {                   \
+            printf("%s:%d: ", __FILE__, __LINE__);          \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    } while (0)
+
+LONG SetVar(CONST_STRPTR name, CONST_STRPTR buffer, LONG size, ULONG flags)
+{
+    (void)name; (void)buffer; (void)size; (void)flags;
+    return 1;
+}
+
+/* =========================================================================
+ * Reference date conversions: the loops tz.c used before the closed
+ * forms, walking from 1978 a year and a month at a time
+ * ========================================================================= */
+
+static void old_secs_to_date(ULONG secs, LONG *year, UBYTE *month,
+                             UBYTE *day, UBYTE *hour)
+{
+    ULONG days_remaining = secs / SECS_PER_DAY;
+    ULONG days_in_year;
+    LONG y;
+    UBYTE m, dim;
+
+    *hour = (UBYTE)((secs % SECS_PER_DAY) / SECS_PER_HOUR);
+
+    y = AMIGA_EPOCH_YEAR;
+    for (;;) {
+        days_in_year = is_leap_year(y) ? 366 : 365;
+        if (days_remaining < days_in_year)
+            break;
+        days_remaining -= days_in_year;
+        y++;
+    }
+    *year = y;
+
+    m = 1;
+    for (;;) {
+        dim = get_days_in_month(y, m);
+        if (days_remaining < dim)
+            break;
+        days_remaining -= dim;
+        m++;
+    }
+    *month = m;
+    *day = (UBYTE)(days_remaining + 1);
+}
+
+static ULONG old_date_to_secs(LONG year, UBYTE month, UBYTE day, UBYTE hour)
+{
+    ULONG secs = 0;
+    LONG y;
+    UBYTE m;
+
+    for (y = AMIGA_EPOCH_YEAR; y < year; y++)
+        secs += (is_leap_year(y) ? 366 : 365) * SECS_PER_DAY;
+    for (m = 1; m < month; m++)
+        secs += get_days_in_month(year, m) * SECS_PER_DAY;
+    secs += (day - 1) * SECS_PER_DAY;
+    secs += hour * SECS_PER_HOUR;
+
+    return secs;
+}
+
+/* Zeller's congruence, 0=Sunday */
+static UBYTE old_day_of_week(LONG year, UBYTE month, UBYTE day)
+{
+    LONG y, m, k, j;
+
+    if (month < 3) {
+        m = month + 12;
+        y = year - 1;
+    } else {
+        m = month;
+        y = year;
+    }
+    k = y % 100;
+    j = y / 100;
+
+    return (UBYTE)(((day + (13 * (m + 1)) / 5 + k + k / 4 + j / 4 -
+                     2 * j) % 7 + 6) % 7);
+}
+
+/* Every day the Amiga clock can hold, 1 January 1978 to 7 February
+ * 2114, at a different second of each day */
+static void test_dates(void)
+{
+    ULONG d, secs;
+    LONG year, old_year;
+    UBYTE month, day, hour, old_month, old_day, old_hour;
+
+    for (d = 0; d <= 0xFFFFFFFFUL / SECS_PER_DAY; d++) {
+        secs = d * SECS_PER_DAY + (d * 7919UL) % SECS_PER_DAY;
+
+        amiga_secs_to_date(secs, &year, &month, &day, &hour);
+        old_secs_to_date(secs, &old_year, &old_month, &old_day, &old_hour);
+        CHECK(year == old_year && month == old_month && day == old_day &&
+              hour == old_hour,
+              "amiga_secs_to_date %lu: %ld-%d-%d %d, want %ld-%d-%d %d",
+              (unsigned long)secs, (long)year, month, day, hour,
+              (long)old_year, old_month, old_day, old_hour);
+
+        CHECK(days_from_civil(year, month, day) == d,
+              "days_from_civil %ld-%d-%d", (long)year, month, day);
+        CHECK(date_to_amiga_secs(year, month, day, (WORD)(hour * 60)) ==
+              old_date_to_secs(year, month, day, hour),
+              "date_to_amiga_secs %ld-%d-%d %d", (long)year, month, day,
+              hour);
+        CHECK(day_of_week(year, month, day) ==
+              old_day_of_week(year, month, day),
+              "day_of_week %ld-%d-%d", (long)year, month, day);
+    }
+
+    /* Rule times outside the day, as in "/-1" and "/24" */
+    CHECK(date_to_amiga_secs(2025, 3, 30, -60) ==
+          old_date_to_secs(2025, 3, 29, 23), "negative rule time");
+    CHECK(date_to_amiga_secs(2025, 10, 30, 24 * 60) ==
+          old_date_to_secs(2025, 10, 31, 0), "rule time of 24:00");
+}
+
+/* =========================================================================
+ * Name lookup
+ * ========================================================================= */
+
+/* The linear scan tz_find_by_name() used before the perfect hash */
+static const TZEntry *old_find_by_name(const char *name)
+{
+    ULONG i;
+
+    if (!name)
+        return NULL;
+    for (i = 0; i < tz_table_count; i++) {
+        if (str_equal(tz_table[i].name, name))
+            return &tz_table[i];
+    }
+    return NULL;
+}
+
+static void test_find_by_name(void)
+{
+    static const char *unknown[] = {
+        "", "Europe", "Europe/", "Europe/Londo", "Europe/London ",
+        "europe/london", "Europe/LondonX", "Nowhere/City", "/", NULL
+    };
+    char buf[64];
+    ULONG i, j;
+
+    CHECK(tz_find_by_name(NULL) == NULL, "NULL name");
+
+    /* Every name maps back to its own entry, from a copy of the name */
+    for (i = 0; i < tz_table_count; i++) {
+        strcpy(buf, tz_table[i].name);
+        CHECK(tz_find_by_name(buf) == &tz_table[i], "%s", buf);
+    }
+
+    for (i = 0; unknown[i]; i++)
+        CHECK(tz_find_by_name(unknown[i]) == NULL, "\"%s\"", unknown[i]);
+
+    /* Every name with one character changed, or with one cut off */
+    for (i = 0; i < tz_table_count; i++) {
+        for (j = 0; tz_table[i].name[j]; j++) {
+            strcpy(buf, tz_table[i].name);
+            buf[j] ^= 0x20;
+            CHECK(tz_find_by_name(buf) == old_find_by_name(buf),
+                  "\"%s\"", buf);
+            buf[j] = '\0';
+            CHECK(tz_find_by_name(buf) == old_find_by_name(buf),
+                  "\"%s\"", buf);
+        }
+    }
+}
+
+/* Host timing of the hash against the linear scan. Only a rough guide
+ * to the 68000, where the scan's string compares cost far more. */
+static void bench_find_by_name(void)
+{
+    static char names[1024][64];
+    const ULONG rounds = 200;
+    volatile ULONG sink = 0;
+    ULONG i, r, n;
+    clock_t t0, t1, t2;
+
+    n = tz_table_count < 1024 ? tz_table_count : 1024;
+    for (i = 0; i < n; i++)
+        strcpy(names[i], tz_table[(i * 7919UL) % tz_table_count].name);
+
+    t0 = clock();
+    for (r = 0; r < rounds; r++)
+        for (i = 0; i < n; i++)
+            sink += (ULONG)(tz_find_by_name(names[i]) - tz_table);
+    t1 = clock();
+    for (r = 0; r < rounds; r++)
+        for (i = 0; i < n; i++)
+            sink += (ULONG)(old_find_by_name(names[i]) - tz_table);
+    t2 = clock();
+
+    printf("tz_find_by_name: hash %.0f ns, linear scan %.0f ns per lookup"
+           " (%lu zones)\n",
+           (double)(t1 - t0) * 1e9 / CLOCKS_PER_SEC / (rounds * n),
+           (double)(t2 - t1) * 1e9 / CLOCKS_PER_SEC / (rounds * n),
+           (unsigned long)tz_table_count);
+    (void)sink;
+}
+
+/* =========================================================================
+ * DST windows: exact transitions, rules and the window cache
+ * ========================================================================= */
+
+/* Zones with exact transitions in tz_table.c, then rule zones */
+static const char *dst_zones[] = {
+    "America/Santiago", "Asia/Jerusalem", "Africa/Casablanca",
+    "Europe/Dublin", "America/New_York", "Europe/Berlin",
+    "Australia/Sydney", NULL
+};
+
+/* Known 2025 transitions, UTC, with the offsets either side */
+static const struct {
+    const char *zone;
+    UBYTE month, day, hour;
+    WORD before, after;
+} known[] = {
+    { "America/Santiago",   4,  6,  3, -180, -240 },
+    { "America/Santiago",   9,  7,  4, -240, -180 },
+    { "Asia/Jerusalem",     3, 28,  0,  120,  180 },
+    { "Asia/Jerusalem",    10, 25, 23,  180,  120 },
+    { "Africa/Casablanca",  2, 23,  2,   60,    0 },
+    { "Africa/Casablanca",  4,  6,  2,    0,   60 },
+    { "Europe/Dublin",      3, 30,  1,    0,   60 },
+    { "Europe/Dublin",     10, 26,  1,   60,    0 },
+    { "America/New_York",   3,  9,  7, -300, -240 },
+    { "America/New_York",  11,  2,  6, -240, -300 },
+    { "Europe/Berlin",      3, 30,  1,   60,  120 },
+    { "Europe/Berlin",     10, 26,  1,  120,   60 },
+    { "Australia/Sydney",   4,  5, 16,  660,  600 },
+    { "Australia/Sydney",  10,  4, 16,  600,  660 }
+};
+
+/* Queries with the cache emptied first */
+static LONG fresh_offset(const TZEntry *tz, ULONG utc_secs)
+{
+    win_tz = NULL;
+    return tz_get_offset_mins(tz, utc_secs);
+}
+
+static BOOL fresh_next(const TZEntry *tz, ULONG utc_secs, ULONG *next)
+{
+    win_tz = NULL;
+    return tz_next_transition(tz, utc_secs, next);
+}
+
+/* The exact state at a UTC time by a linear scan of the zone's
+ * transitions, as a reference for the binary search */
+static LONG scan_offset(const TZEntry *tz, ULONG utc_secs, BOOL *dst)
+{
+    const ULONG *t = &tz_transitions[tz->trans_first];
+    UWORD i, last = 0;
+
+    for (i = 0; i < tz->trans_count; i++) {
+        if (tz_trans_from + MINS_TO_SECS(TZ_TRANS_MINS(t[i])) <= utc_secs)
+            last = i;
+    }
+    *dst = (t[last] & TZ_TRANS_DST) != 0;
+    return TZ_TRANS_OFFSET(t[last]) * 15;
+}
+
+static void test_known_transitions(void)
+{
+    const TZEntry *tz;
+    ULONG i, at, next;
+
+    for (i = 0; i < sizeof(known) / sizeof(known[0]); i++) {
+        tz = tz_find_by_name(known[i].zone);
+        CHECK(tz != NULL, "%s missing", known[i].zone);
+        if (tz == NULL)
+            continue;
+
+        at = date_to_amiga_secs(2025, known[i].month, known[i].day,
+                                (WORD)(known[i].hour * 60));
+        CHECK(fresh_offset(tz, at - 1) == known[i].before &&
+              fresh_offset(tz, at) == known[i].after,
+              "%s 2025-%02d-%02d: offset %ld/%ld, want %d/%d",
+              known[i].zone, known[i].month, known[i].day,
+              (long)fresh_offset(tz, at - 1), (long)fresh_offset(tz, at),
+              known[i].before, known[i].after);
+        CHECK(fresh_next(tz, at - 1, &next) && next == at,
+              "%s 2025-%02d-%02d: next transition", known[i].zone,
+              known[i].month, known[i].day);
+        CHECK(fresh_next(tz, at - 86400, &next) && next == at,
+              "%s 2025-%02d-%02d: next transition a day before",
+              known[i].zone, known[i].month, known[i].day);
+    }
+}
+
+/* Walks each zone from a year before the exact span to a year after it,
+ * transition by transition, checking times just before and after each
+ * one and either side of both span ends. Each transition must change
+ * the offset, and none may be skipped (sampled every 6 hours). */
+static void test_transition_walk(void)
+{
+    const ULONG edge[] = { tz_trans_from, tz_trans_until };
+    const TZEntry *tz;
+    ULONG i, j, t, at, next, end, found;
+    LONG offset;
+    BOOL dst;
+
+    for (i = 0; dst_zones[i]; i++) {
+        tz = tz_find_by_name(dst_zones[i]);
+        if (tz == NULL)
+            continue;
+
+        t = tz_trans_from - 366 * SECS_PER_DAY;
+        end = tz_trans_until + 366 * SECS_PER_DAY;
+        found = 0;
+        while (t < end) {
+            offset = fresh_offset(tz, t);
+            if (!fresh_next(tz, t, &next)) {
+                next = end;
+            } else {
+                CHECK(next > t && fresh_offset(tz, next - 1) == offset &&
+                      fresh_offset(tz, next) != offset,
+                      "%s: %lu is not a change after %lu", dst_zones[i],
+                      (unsigned long)next, (unsigned long)t);
+                found++;
+            }
+            for (j = t; j < next && j < end; j += 6 * SECS_PER_HOUR)
+                CHECK(fresh_offset(tz, j) == offset,
+                      "%s: change at %lu missed", dst_zones[i],
+                      (unsigned long)j);
+            t = next;
+        }
+        CHECK(found >= 2 * (tz_trans_until - tz_trans_from) /
+                       (366 * SECS_PER_DAY),
+              "%s: only %lu transitions", dst_zones[i],
+              (unsigned long)found);
+
+        /* Inside the span the binary search matches a linear scan */
+        for (j = 0; j < tz->trans_count; j++) {
+            at = tz_trans_from +
+                MINS_TO_SECS(TZ_TRANS_MINS(tz_transitions[tz->trans_first + j]));
+            for (t = (at > tz_trans_from) ? at - 1 : at; t <= at + 1; t++) {
+                offset = scan_offset(tz, t, &dst);
+                CHECK(fresh_offset(tz, t) == offset &&
+                      tz_is_dst_active(tz, t) == dst,
+                      "%s: table lookup at %lu", dst_zones[i],
+                      (unsigned long)t);
+            }
+        }
+
+        /* Either side of the span ends, from a cold and a warm cache */
+        for (j = 0; j < 2; j++) {
+            for (t = edge[j] - 2; t != edge[j] + 2; t++) {
+                offset = fresh_offset(tz, t);
+                CHECK(tz_get_offset_mins(tz, t) == offset &&
+                      tz_get_offset_mins(tz, t + 1) == fresh_offset(tz, t + 1),
+                      "%s: offset around span end %lu", dst_zones[i],
+                      (unsigned long)edge[j]);
+            }
+        }
+    }
+}
+
+/* Random times in and around the span, zones interleaved so the cache
+ * keeps changing hands: cached answers must match cold ones */
+static void test_window_cache(void)
+{
+    const TZEntry *zones[16];
+    const TZEntry *tz;
+    ULONG n, i, t, span, next, fresh;
+    LONG offset;
+    BOOL dst, has, fresh_has;
+
+    for (n = 0; dst_zones[n]; n++)
+        zones[n] = tz_find_by_name(dst_zones[n]);
+    zones[n++] = tz_find_by_name("Asia/Tokyo");     /* No DST */
+    zones[n++] = tz_find_by_name("America/Coyhaique");
+
+    span = tz_trans_until - tz_trans_from + 4 * 366 * SECS_PER_DAY;
+    t = tz_trans_from - 2 * 366 * SECS_PER_DAY;
+    for (i = 0; i < 400000; i++) {
+        tz = zones[i % n];
+        if (tz == NULL)
+            continue;
+
+        /* Mostly small steps forward, as a running clock asks */
+        if ((i & 15) == 0)
+            t = tz_trans_from - 2 * 366 * SECS_PER_DAY +
+                (ULONG)(((unsigned long long)i * 2654435761UL) % span);
+        else
+            t += 3607;
+
+        offset = tz_get_offset_mins(tz, t);
+        dst = tz_is_dst_active(tz, t);
+        has = tz_next_transition(tz, t, &next);
+        fresh_has = fresh_next(tz, t, &fresh);
+        CHECK(offset == fresh_offset(tz, t), "%s at %lu: offset",
+              tz->name, (unsigned long)t);
+        win_tz = NULL;
+        CHECK(dst == tz_is_dst_active(tz, t), "%s at %lu: DST",
+              tz->name, (unsigned long)t);
+        CHECK(has == fresh_has && (!has || next == fresh),
+              "%s at %lu: next transition", tz->name, (unsigned long)t);
+    }
+}
+
+/* Host timing of cached offset lookups against evaluating the rules
+ * or searching the exact table every time, for a clock read once a
+ * second */
+static void bench_offsets(void)
+{
+    static const char *names[] = { "Europe/Berlin", "America/Santiago" };
+    const ULONG count = 2000000;
+    volatile LONG sink = 0;
+    const TZEntry *tz;
+    ULONG i, z, t0;
+    clock_t c0, c1, c2;
+
+    for (z = 0; z < 2; z++) {
+        tz = tz_find_by_name(names[z]);
+        if (tz == NULL)
+            continue;
+        t0 = tz_trans_from + 100 * SECS_PER_DAY;
+
+        c0 = clock();
+        for (i = 0; i < count; i++)
+            sink += tz_get_offset_mins(tz, t0 + i);
+        c1 = clock();
+        for (i = 0; i < count; i++) {
+            win_tz = NULL;
+            sink += tz_get_offset_mins(tz, t0 + i);
+        }
+        c2 = clock();
+
+        CHECK(c1 - c0 < c2 - c1, "%s: cache slower than %s", names[z],
+              tz->trans_count ? "the table" : "the rules");
+        printf("tz_get_offset_mins %s: cached %.1f ns, %s %.1f ns"
+               " per lookup\n", names[z],
+               (double)(c1 - c0) * 1e9 / CLOCKS_PER_SEC / count,
+               tz->trans_count ? "table search" : "rule evaluation",
+               (double)(c2 - c1) * 1e9 / CLOCKS_PER_SEC / count);
+    }
+    (void)sink;
+}
+
+int main(void)
+{
+    test_dates();
+    test_find_by_name();
+    test_known_transitions();
+    test_transition_walk();
+    test_window_cache();
+    bench_find_by_name();
+    bench_offsets();
+
+    printf("test_tz: %lu checks, %lu failures\n",
+           (unsigned long)checks, (unsigned long)failures);
+    return failures ? 1 : 0;
+}